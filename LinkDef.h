@@ -0,0 +1,58 @@
+/*
+    Selection of the ROOT dictionary of libRNOGConfigReader, so that macros can gSystem->Load("libRNOGConfigReader") and call the
+    precompiled functions. Classes holding threads, mutexes or mapped memory are left to compiled code.
+*/
+
+#ifdef __CLING__
+
+#pragma link off all globals;
+#pragma link off all classes;
+#pragma link off all functions;
+
+#pragma link C++ enum ConfigStatus;
+#pragma link C++ enum ConfigChangeKind;
+#pragma link C++ struct ConfigRun+;
+#pragma link C++ struct RunConfigValues+;
+#pragma link C++ struct ConfigChange+;
+#pragma link C++ struct ConfigLocation+;
+#pragma link C++ struct ConfigBranchSpec+;
+#pragma link C++ enum ConfigSchemaType;
+#pragma link C++ enum ConfigViolationKind;
+#pragma link C++ struct ConfigSchemaRule+;
+#pragma link C++ struct ConfigViolation+;
+#pragma link C++ enum ConfigArchiveCompression;
+
+#pragma link C++ function configStatusMessage;
+#pragma link C++ function getConfigFilepath;
+#pragma link C++ function setConfigBaseDirectory;
+#pragma link C++ function getConfigBaseDirectory;
+#pragma link C++ function registerCommonSettingAlias;
+#pragma link C++ function resolveCommonSettingAlias;
+#pragma link C++ function settingValueToString;
+#pragma link C++ function getSettingValue;
+#pragma link C++ function getCommonSettingValue;
+#pragma link C++ function tryGetSettingValue;
+#pragma link C++ function tryGetCommonSettingValue;
+#pragma link C++ function readConfigFile;
+#pragma link C++ function findConfigRuns;
+#pragma link C++ function scanConfigFiles;
+#pragma link C++ function printConfigTable;
+#pragma link C++ function updateConfigSnapshot;
+#pragma link C++ function streamConfigChanges;
+#pragma link C++ function validateConfigs;
+#pragma link C++ function printConfigViolations;
+#pragma link C++ function scanConfigArchive;
+#pragma link C++ function exportConfigTree;
+#pragma link C++ function configReader;
+#pragma link C++ function configScanner;
+#pragma link C++ function configSnapshot;
+#pragma link C++ function configChanges;
+#pragma link C++ function configQuery;
+#pragma link C++ function configIndex;
+#pragma link C++ function configServer;
+#pragma link C++ function configWatch;
+#pragma link C++ function configValidate;
+#pragma link C++ function configArchive;
+#pragma link C++ function configTree;
+
+#endif
@@ -0,0 +1,4437 @@
+/*
+    Written by Joneskim Kimo, 2023
+    Definitions of the RNO-G configuration reader library, see RNOGConfigReader.h for the documentation of every function.
+*/
+
+#include "RNOGConfigReader.h"
+
+void appendSettingValue(std::string& out, const libconfig::Setting& setting)
+{
+    switch (setting.getType())
+    {
+    case libconfig::Setting::TypeInt:
+        appendInteger(out, static_cast<int>(setting));
+        break;
+    case libconfig::Setting::TypeInt64:
+        appendInteger(out, static_cast<long long>(setting));
+        break;
+    case libconfig::Setting::TypeString:
+        out += static_cast<const char*>(setting);
+        break;
+    case libconfig::Setting::TypeBoolean:
+        out += static_cast<bool>(setting) ? '1' : '0';
+        break;
+    case libconfig::Setting::TypeFloat:
+        appendFloat(out, static_cast<float>(setting), std::chars_format::fixed);
+        break;
+    case libconfig::Setting::TypeArray:
+    case libconfig::Setting::TypeList:
+    {
+        const bool isArray = setting.getType() == libconfig::Setting::TypeArray;
+        appendElements(out, setting.getLength(), isArray ? '[' : '(', isArray ? ']' : ')', [&setting](std::string& text, int i)
+        {
+            const libconfig::Setting& subsetting = setting[i];
+            if (subsetting.getType() == libconfig::Setting::TypeInt)
+            {
+                appendInteger(text, static_cast<int>(subsetting));
+            }
+            else if (subsetting.getType() == libconfig::Setting::TypeInt64)
+            {
+                appendInteger(text, static_cast<long long>(subsetting));
+            }
+            else if (subsetting.getType() == libconfig::Setting::TypeFloat)
+            {
+                appendFloat(text, static_cast<float>(subsetting), std::chars_format::general);
+            }
+        });
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+std::string settingValueToString(const libconfig::Setting& setting, const std::string& path)
+{
+    std::string value;
+    appendSettingValue(value, setting);
+    return value;
+}
+
+ConfigInstrumentationStats ConfigInstrumentation::getStats() const
+{
+    ConfigInstrumentationStats stats;
+    stats.filesParsed = filesParsed.load(std::memory_order_relaxed);
+    stats.bytesRead = bytesRead.load(std::memory_order_relaxed);
+    stats.parseNanoseconds = parseNanoseconds.load(std::memory_order_relaxed);
+    stats.readConfigFileCalls = readConfigFileCalls.load(std::memory_order_relaxed);
+    stats.readConfigFileNanoseconds = readConfigFileNanoseconds.load(std::memory_order_relaxed);
+    stats.lookups = lookups.load(std::memory_order_relaxed);
+    stats.lookupMisses = lookupMisses.load(std::memory_order_relaxed);
+    stats.commonLookups = commonLookups.load(std::memory_order_relaxed);
+    stats.aliasMisses = aliasMisses.load(std::memory_order_relaxed);
+    stats.cacheHits = cacheHits.load(std::memory_order_relaxed);
+    stats.cacheMisses = cacheMisses.load(std::memory_order_relaxed);
+    stats.exceptions = exceptions.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ConfigInstrumentation::recordRun(int station, int run, uint64_t nanoseconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ConfigStationStats& stats = stations_[station];
+    stats.station = station;
+    ++stats.reads;
+    stats.nanoseconds += nanoseconds;
+    if (nanoseconds > stats.slowestNanoseconds)
+    {
+        stats.slowestRun = run;
+        stats.slowestNanoseconds = nanoseconds;
+    }
+}
+
+void ConfigInstrumentation::print(std::ostream& out) const
+{
+    const ConfigInstrumentationStats stats = getStats();
+    out << "config files parsed: " << stats.filesParsed << ", " << stats.bytesRead << " bytes, " << stats.parseNanoseconds / 1e6 << " ms\n"
+        << "readConfigFile: " << stats.readConfigFileCalls << " calls, " << stats.readConfigFileNanoseconds / 1e6 << " ms\n"
+        << "cache: " << stats.cacheHits << " hits, " << stats.cacheMisses << " misses\n"
+        << "getSettingValue: " << stats.lookups << " lookups, " << stats.lookupMisses << " missing\n"
+        << "getCommonSettingValue: " << stats.commonLookups << " lookups, " << stats.aliasMisses << " unknown aliases\n"
+        << "exceptions: " << stats.exceptions << "\n";
+    for (const ConfigStationStats& station : getStationStats())
+    {
+        out << "station" << station.station << ": " << station.reads << " reads, " << station.nanoseconds / 1e6 << " ms, slowest run"
+            << station.slowestRun << " " << station.slowestNanoseconds / 1e6 << " ms\n";
+    }
+    out.flush();
+}
+
+ConfigInstrumentation& getConfigInstrumentation()
+{
+    static ConfigInstrumentation instrumentation;
+    return instrumentation;
+}
+
+const char* configStatusMessage(ConfigStatus status)
+{
+    switch (status)
+    {
+    case ConfigStatus::Ok:
+        return "OK";
+    case ConfigStatus::NotFound:
+        return "Setting not found";
+    case ConfigStatus::TypeMismatch:
+        return "Setting has an incompatible type";
+    case ConfigStatus::UnknownAlias:
+        return "Unknown common setting alias";
+    case ConfigStatus::IOError:
+        return "I/O error while reading file";
+    case ConfigStatus::ParseError:
+        return "Parse error";
+    case ConfigStatus::InvalidFormat:
+        return "Invalid format";
+    }
+    return "Unknown error";
+}
+
+void ConfigErrorLog::report(ConfigStatus status, std::string_view key, std::string_view detail)
+{
+    std::string id(1, static_cast<char>(status));
+    id.append(key.data(), key.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    ConfigErrorCount& entry = errors_[id];
+    if (entry.count++ == 0)
+    {
+        entry.status = status;
+        entry.key.assign(key.data(), key.size());
+        entry.detail.assign(detail.data(), detail.size());
+    }
+    ++totalCount_;
+    if (!output_ || entry.count > printsPerError_)
+    {
+        return;
+    }
+    if (printed_ < maxPrints_)
+    {
+        *output_ << "Error: " << configStatusMessage(status) << ": " << key;
+        if (!detail.empty())
+        {
+            *output_ << " - " << detail;
+        }
+        *output_ << std::endl;
+    }
+    else if (printed_ == maxPrints_)
+    {
+        *output_ << "Error: further configuration errors are only counted, see getConfigErrorLog().printSummary()" << std::endl;
+    }
+    ++printed_;
+}
+
+std::vector<ConfigErrorCount> ConfigErrorLog::getSummary() const
+{
+    std::vector<ConfigErrorCount> summary;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        summary.reserve(errors_.size());
+        for (const auto& entry : errors_)
+        {
+            summary.push_back(entry.second);
+        }
+    }
+    std::sort(summary.begin(), summary.end(), [](const ConfigErrorCount& a, const ConfigErrorCount& b)
+    {
+        return a.count != b.count ? a.count > b.count : a.key < b.key;
+    });
+    return summary;
+}
+
+void ConfigErrorLog::printSummary(std::ostream& out) const
+{
+    for (const ConfigErrorCount& error : getSummary())
+    {
+        out << error.count << "\t" << configStatusMessage(error.status) << "\t" << error.key;
+        if (!error.detail.empty())
+        {
+            out << "\t" << error.detail;
+        }
+        out << "\n";
+    }
+    out.flush();
+}
+
+ConfigErrorLog& getConfigErrorLog()
+{
+    static ConfigErrorLog log;
+    return log;
+}
+
+size_t estimateRenderedSize(const libconfig::Setting& setting)
+{
+    switch (setting.getType())
+    {
+    case libconfig::Setting::TypeGroup:
+    {
+        size_t size = 4;
+        for (int i = 0; i < setting.getLength(); ++i)
+        {
+            const char* name = setting[i].getName();
+            size += (name ? std::strlen(name) : 0) + 6 + estimateRenderedSize(setting[i]);
+        }
+        return size;
+    }
+    case libconfig::Setting::TypeArray:
+    case libconfig::Setting::TypeList:
+        return 2 + 12 * static_cast<size_t>(setting.getLength());
+    case libconfig::Setting::TypeString:
+        return std::strlen(static_cast<const char*>(setting));
+    default:
+        return 16;
+    }
+}
+
+void appendGroupValue(std::string& out, const libconfig::Setting& group)
+{
+    const int length = group.getLength();
+    if (length == 0)
+    {
+        return;
+    }
+    out += "{\n";
+    for (int i = 0; i < length; ++i)
+    {
+        const libconfig::Setting& subsetting = group[i];
+        if (i != 0)
+        {
+            out += ", \n";
+        }
+        out += subsetting.getName();
+        out += " = ";
+        if (subsetting.getType() == libconfig::Setting::TypeGroup)
+        {
+            appendGroupValue(out, subsetting);
+        }
+        else
+        {
+            appendSettingValue(out, subsetting);
+        }
+    }
+    out += "\n}";
+}
+
+std::string renderSetting(const libconfig::Setting& setting)
+{
+    std::string value;
+    value.reserve(estimateRenderedSize(setting));
+    if (setting.getType() == libconfig::Setting::TypeGroup)
+    {
+        appendGroupValue(value, setting);
+    }
+    else
+    {
+        appendSettingValue(value, setting);
+    }
+    return value;
+}
+
+const libconfig::Setting* findSetting(const libconfig::Setting& root, std::string_view path)
+{
+    // Follows config_setting_lookup of libconfig, which exists() and lookup() use
+    auto isSeparator = [](char c) { return c == '.' || c == ':' || c == '/'; };
+    const libconfig::Setting* found = &root;
+    size_t position = 0;
+    while (position < path.size())
+    {
+        if (isSeparator(path[position]))
+        {
+            ++position;
+        }
+        if (position < path.size() && path[position] == '[')
+        {
+            // libconfig reads the index with strtol: spaces and a sign may lead, and "[]" holds no number, which is index 0
+            size_t end = position + 1;
+            while (end < path.size() && (path[end] == ' ' || (path[end] >= '\t' && path[end] <= '\r')))
+            {
+                ++end;
+            }
+            const bool negative = end < path.size() && path[end] == '-';
+            end += end < path.size() && (path[end] == '-' || path[end] == '+') ? 1 : 0;
+            const size_t digits = end;
+            long long index = 0;
+            while (end < path.size() && path[end] >= '0' && path[end] <= '9' && index <= std::numeric_limits<int>::max())
+            {
+                index = index * 10 + (path[end] - '0');
+                ++end;
+            }
+            end = end == digits ? position + 1 : end;
+            if (end == path.size() || path[end] != ']')
+            {
+                return nullptr;
+            }
+            if (!found->isAggregate() || (negative && index != 0) || index >= found->getLength())
+            {
+                return nullptr;
+            }
+            found = &(*found)[static_cast<int>(index)];
+            position = end + 1;
+        }
+        else if (found->isGroup())
+        {
+            size_t end = position;
+            while (end < path.size() && !isSeparator(path[end]) && path[end] != '[')
+            {
+                ++end;
+            }
+            const std::string_view name = path.substr(position, end - position);
+            const libconfig::Setting* member = nullptr;
+            for (int i = 0, length = found->getLength(); i < length && !member; ++i)
+            {
+                const char* memberName = (*found)[i].getName();
+                if (memberName && std::strncmp(memberName, name.data(), name.size()) == 0 && memberName[name.size()] == '\0')
+                {
+                    member = &(*found)[i];
+                }
+            }
+            if (!member)
+            {
+                return nullptr;
+            }
+            found = member;
+            position = end;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return position < path.size() || found == &root ? nullptr : found;
+}
+
+ConfigStatus tryGetSettingValue(const libconfig::Config& config, const std::string& path, std::string& value)
+{
+    value.clear();
+    const libconfig::Setting* setting = findSetting(config.getRoot(), path);
+    if (!setting)
+    {
+        return ConfigStatus::NotFound;
+    }
+    value = renderSetting(*setting);
+    return ConfigStatus::Ok;
+}
+
+std::string getSettingValue(const libconfig::Config& config, const std::string& path)
+{
+    RNOG_CONFIG_COUNT(lookups, 1);
+    std::string value;
+    ConfigStatus status = tryGetSettingValue(config, path, value);
+    if (status != ConfigStatus::Ok)
+    {
+        RNOG_CONFIG_COUNT(lookupMisses, 1);
+        getConfigErrorLog().report(status, path);
+    }
+    return value;
+}
+
+UserSettingAliases& getUserSettingAliases()
+{
+    static UserSettingAliases userAliases;
+    return userAliases;
+}
+
+bool registerCommonSettingAlias(const std::string& alias, const std::string& path)
+{
+    if (alias.find('.') != std::string::npos || !findCommonSettingPath(alias).empty())
+    {
+        return false;
+    }
+    UserSettingAliases& userAliases = getUserSettingAliases();
+    std::unique_lock<std::shared_mutex> lock(userAliases.mutex);
+    bool added = userAliases.aliases.emplace(alias, path).second;
+    userAliases.empty = false;
+    return added;
+}
+
+size_t registerCommonSettingAliases(const std::vector<std::pair<std::string, std::string>>& aliases)
+{
+    size_t added = 0;
+    for (const auto& alias : aliases)
+    {
+        added += registerCommonSettingAlias(alias.first, alias.second);
+    }
+    return added;
+}
+
+std::string_view resolveCommonSettingAlias(std::string_view alias)
+{
+    std::string_view path = findCommonSettingPath(alias);
+    if (!path.empty())
+    {
+        return path;
+    }
+    UserSettingAliases& userAliases = getUserSettingAliases();
+    if (userAliases.empty)
+    {
+        return std::string_view();
+    }
+    std::shared_lock<std::shared_mutex> lock(userAliases.mutex);
+    auto it = userAliases.aliases.find(alias);
+    return it != userAliases.aliases.end() ? std::string_view(it->second) : std::string_view();
+}
+
+SettingPathId SettingPathPool::intern(std::string_view path)
+{
+    SettingPathId id = find(path);
+    if (id != invalidSettingPathId)
+    {
+        return id;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(path);
+    if (it != ids_.end())
+    {
+        return it->second;
+    }
+    id = static_cast<SettingPathId>(paths_.size());
+    paths_.emplace_back(path);
+    ids_.emplace(paths_.back(), id);
+    return id;
+}
+
+SettingPathPool& getSettingPathPool()
+{
+    static SettingPathPool pool;
+    return pool;
+}
+
+SettingPathId resolveCommonSettingId(std::string_view alias)
+{
+    // Paths come from users and clients, so they are only looked up; interning them would grow the pool with every new path
+    if (alias.find('.') != std::string_view::npos)
+    {
+        return getSettingPathPool().find(alias);
+    }
+    std::string_view path = resolveCommonSettingAlias(alias);
+    return path.empty() ? invalidSettingPathId : getSettingPathPool().intern(path);
+}
+
+ConfigStatus tryGetSettingValue(const libconfig::Config& config, SettingPathId id, std::string& value)
+{
+    value.clear();
+    if (id == invalidSettingPathId)
+    {
+        return ConfigStatus::NotFound;
+    }
+    const libconfig::Setting* setting = findSetting(config.getRoot(), getSettingPathPool().getPath(id));
+    if (!setting)
+    {
+        return ConfigStatus::NotFound;
+    }
+    value = renderSetting(*setting);
+    return ConfigStatus::Ok;
+}
+
+std::string getSettingValue(const libconfig::Config& config, SettingPathId id)
+{
+    RNOG_CONFIG_COUNT(lookups, 1);
+    std::string value;
+    ConfigStatus status = tryGetSettingValue(config, id, value);
+    if (status != ConfigStatus::Ok)
+    {
+        RNOG_CONFIG_COUNT(lookupMisses, 1);
+        getConfigErrorLog().report(status, id == invalidSettingPathId ? std::string_view() : getSettingPathPool().getPath(id));
+    }
+    return value;
+}
+
+std::string getCommonSettingValue(const libconfig::Config& config, const std::string& alias)
+{
+    RNOG_CONFIG_COUNT(commonLookups, 1);
+    if (alias.find(".") != std::string::npos)
+    {
+        return getSettingValue(config, alias);
+    }
+
+    SettingPathId id = resolveCommonSettingId(alias);
+    if (id != invalidSettingPathId)
+    {
+        return getSettingValue(config, id);
+    }
+    else
+    {
+        RNOG_CONFIG_COUNT(aliasMisses, 1);
+        getConfigErrorLog().report(ConfigStatus::UnknownAlias, alias);
+        // Return empty string if alias is not found
+        return "";
+    }
+}
+
+ConfigStatus tryGetCommonSettingValue(const libconfig::Config& config, const std::string& alias, std::string& value)
+{
+    if (alias.find(".") != std::string::npos)
+    {
+        return tryGetSettingValue(config, alias, value);
+    }
+    SettingPathId id = resolveCommonSettingId(alias);
+    if (id == invalidSettingPathId)
+    {
+        value.clear();
+        return ConfigStatus::UnknownAlias;
+    }
+    return tryGetSettingValue(config, id, value);
+}
+
+const FlatSetting* FlatConfig::find(std::string_view path) const noexcept
+{
+    const uint32_t* last = sorted_ + settingsSize_;
+    const uint32_t* it = std::lower_bound(sorted_, last, path, [this](uint32_t index, std::string_view p)
+    {
+        return getPath(settings_[index]) < p;
+    });
+    if (it != last && getPath(settings_[*it]) == path)
+    {
+        return &settings_[*it];
+    }
+    return nullptr;
+}
+
+FlatValue FlatConfigTables::makeScalar(const libconfig::Setting& setting)
+{
+    FlatValue value;
+    switch (setting.getType())
+    {
+    case libconfig::Setting::TypeInt:
+        value.type = FlatType::Int;
+        value.intValue = static_cast<int>(setting);
+        break;
+    case libconfig::Setting::TypeInt64:
+        value.type = FlatType::Int64;
+        value.intValue = static_cast<long long>(setting);
+        break;
+    case libconfig::Setting::TypeFloat:
+        value.type = FlatType::Float;
+        value.floatValue = static_cast<double>(setting);
+        break;
+    case libconfig::Setting::TypeBoolean:
+        value.type = FlatType::Boolean;
+        value.boolValue = static_cast<bool>(setting);
+        break;
+    case libconfig::Setting::TypeString:
+    {
+        const char* text = setting;
+        size_t length = std::strlen(text);
+        value.type = FlatType::String;
+        value.text.offset = addString(text, length);
+        value.text.length = static_cast<uint32_t>(length);
+        break;
+    }
+    default:
+        break;
+    }
+    return value;
+}
+
+void FlatConfigTables::add(const libconfig::Setting& setting, std::string& path)
+{
+    size_t parentLength = path.size();
+    if (parentLength != 0)
+    {
+        path += '.';
+    }
+    size_t nameOffset = path.size();
+    path += setting.getName();
+
+    uint32_t index = static_cast<uint32_t>(settings.size());
+    settings.emplace_back();
+    FlatSetting flat;
+    flat.pathOffset = addString(path.data(), path.size());
+    flat.pathLength = static_cast<uint32_t>(path.size());
+    flat.nameOffset = static_cast<uint32_t>(nameOffset);
+
+    if (setting.getType() == libconfig::Setting::TypeGroup)
+    {
+        flat.value.type = FlatType::Group;
+        for (int i = 0; i < setting.getLength(); ++i)
+        {
+            add(setting[i], path);
+        }
+    }
+    else if (setting.getType() == libconfig::Setting::TypeArray || setting.getType() == libconfig::Setting::TypeList)
+    {
+        flat.value.type = setting.getType() == libconfig::Setting::TypeArray ? FlatType::Array : FlatType::List;
+        flat.value.elements.offset = static_cast<uint32_t>(elements.size());
+        flat.value.elements.length = static_cast<uint32_t>(setting.getLength());
+        for (int i = 0; i < setting.getLength(); ++i)
+        {
+            elements.push_back(makeScalar(setting[i]));
+        }
+    }
+    else
+    {
+        flat.value = makeScalar(setting);
+    }
+
+    flat.end = static_cast<uint32_t>(settings.size());
+    settings[index] = flat;
+    path.resize(parentLength);
+}
+
+void FlatConfigTables::sortIndex()
+{
+    sorted.resize(settings.size());
+    for (uint32_t i = 0; i < sorted.size(); ++i)
+    {
+        sorted[i] = i;
+    }
+    std::sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b)
+    {
+        return std::string_view(strings.data() + settings[a].pathOffset, settings[a].pathLength)
+             < std::string_view(strings.data() + settings[b].pathOffset, settings[b].pathLength);
+    });
+}
+
+FlatValue FlatConfigTables::copyValue(const FlatConfig& source, const FlatValue& value)
+{
+    FlatValue copy = value;
+    if (value.type == FlatType::String)
+    {
+        std::string_view text = source.getString(value);
+        copy.text.offset = addString(text.data(), text.size());
+    }
+    else if (value.type == FlatType::Array || value.type == FlatType::List)
+    {
+        const FlatValue* sourceElements = source.getElements(value);
+        copy.elements.offset = static_cast<uint32_t>(elements.size());
+        for (uint32_t i = 0; i < value.elements.length; ++i)
+        {
+            elements.push_back(copyValue(source, sourceElements[i]));
+        }
+    }
+    return copy;
+}
+
+FlatConfig flattenConfig(const libconfig::Config& config)
+{
+    std::shared_ptr<FlatConfigTables> tables = std::make_shared<FlatConfigTables>();
+    const libconfig::Setting& root = config.getRoot();
+    std::string path;
+    for (int i = 0; i < root.getLength(); ++i)
+    {
+        tables->add(root[i], path);
+    }
+    tables->sortIndex();
+    return FlatConfigTables::makeFlatConfig(std::move(tables));
+}
+
+void appendFlatValue(std::string& out, const FlatConfig& flat, const FlatValue& value)
+{
+    switch (value.type)
+    {
+    case FlatType::Int:
+    case FlatType::Int64:
+        appendInteger(out, value.intValue);
+        break;
+    case FlatType::String:
+        out += flat.getString(value);
+        break;
+    case FlatType::Boolean:
+        out += value.boolValue ? '1' : '0';
+        break;
+    case FlatType::Float:
+        appendFloat(out, static_cast<float>(value.floatValue), std::chars_format::fixed);
+        break;
+    case FlatType::Array:
+    case FlatType::List:
+    {
+        const FlatValue* elements = flat.getElements(value);
+        const bool isArray = value.type == FlatType::Array;
+        appendElements(out, static_cast<int>(value.elements.length), isArray ? '[' : '(', isArray ? ']' : ')', [elements](std::string& text, int i)
+        {
+            if (elements[i].type == FlatType::Int || elements[i].type == FlatType::Int64)
+            {
+                appendInteger(text, elements[i].intValue);
+            }
+            else if (elements[i].type == FlatType::Float)
+            {
+                appendFloat(text, static_cast<float>(elements[i].floatValue), std::chars_format::general);
+            }
+        });
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+std::string flatValueToString(const FlatConfig& flat, const FlatValue& value)
+{
+    std::string text;
+    appendFlatValue(text, flat, value);
+    return text;
+}
+
+void appendFlatGroupValue(std::string& out, const FlatConfig& flat, const FlatSetting& group)
+{
+    const uint32_t first = flat.indexOf(group) + 1;
+    if (first == group.end)
+    {
+        return;
+    }
+    out += "{\n";
+    for (uint32_t i = first; i < group.end; i = flat[i].end)
+    {
+        const FlatSetting& subsetting = flat[i];
+        if (i != first)
+        {
+            out += ", \n";
+        }
+        out += flat.getName(subsetting);
+        out += " = ";
+        if (subsetting.value.type == FlatType::Group)
+        {
+            appendFlatGroupValue(out, flat, subsetting);
+        }
+        else
+        {
+            appendFlatValue(out, flat, subsetting.value);
+        }
+    }
+    out += "\n}";
+}
+
+ConfigStatus tryGetSettingValue(const FlatConfig& flat, std::string_view path, std::string& value)
+{
+    value.clear();
+    const FlatSetting* setting = flat.find(path);
+    if (!setting)
+    {
+        return ConfigStatus::NotFound;
+    }
+    if (setting->value.type == FlatType::Group)
+    {
+        appendFlatGroupValue(value, flat, *setting);
+    }
+    else
+    {
+        appendFlatValue(value, flat, setting->value);
+    }
+    return ConfigStatus::Ok;
+}
+
+std::string getSettingValue(const FlatConfig& flat, std::string_view path)
+{
+    RNOG_CONFIG_COUNT(lookups, 1);
+    std::string value;
+    ConfigStatus status = tryGetSettingValue(flat, path, value);
+    if (status != ConfigStatus::Ok)
+    {
+        RNOG_CONFIG_COUNT(lookupMisses, 1);
+        getConfigErrorLog().report(status, path);
+    }
+    return value;
+}
+
+ConfigStatus tryGetSettingValue(const FlatConfig& flat, SettingPathId id, std::string& value)
+{
+    if (id == invalidSettingPathId)
+    {
+        value.clear();
+        return ConfigStatus::NotFound;
+    }
+    return tryGetSettingValue(flat, getSettingPathPool().getPath(id), value);
+}
+
+std::string getSettingValue(const FlatConfig& flat, SettingPathId id)
+{
+    if (id == invalidSettingPathId)
+    {
+        RNOG_CONFIG_COUNT(lookups, 1);
+        RNOG_CONFIG_COUNT(lookupMisses, 1);
+        getConfigErrorLog().report(ConfigStatus::NotFound, std::string_view());
+        return "";
+    }
+    return getSettingValue(flat, getSettingPathPool().getPath(id));
+}
+
+std::string getCommonSettingValue(const FlatConfig& flat, const std::string& alias)
+{
+    RNOG_CONFIG_COUNT(commonLookups, 1);
+    if (alias.find(".") != std::string::npos)
+    {
+        return getSettingValue(flat, alias);
+    }
+
+    std::string_view path = resolveCommonSettingAlias(alias);
+    if (!path.empty())
+    {
+        return getSettingValue(flat, path);
+    }
+    RNOG_CONFIG_COUNT(aliasMisses, 1);
+    getConfigErrorLog().report(ConfigStatus::UnknownAlias, alias);
+    return "";
+}
+
+ConfigStatus tryGetCommonSettingValue(const FlatConfig& flat, const std::string& alias, std::string& value)
+{
+    if (alias.find(".") != std::string::npos)
+    {
+        return tryGetSettingValue(flat, alias, value);
+    }
+    std::string_view path = resolveCommonSettingAlias(alias);
+    if (path.empty())
+    {
+        value.clear();
+        return ConfigStatus::UnknownAlias;
+    }
+    return tryGetSettingValue(flat, path, value);
+}
+
+bool flatValuesEqual(const FlatConfig& a, const FlatValue& x, const FlatConfig& b, const FlatValue& y)
+{
+    if (x.type != y.type)
+    {
+        return false;
+    }
+    switch (x.type)
+    {
+    case FlatType::Int:
+    case FlatType::Int64:
+        return x.intValue == y.intValue;
+    case FlatType::Float:
+        return x.floatValue == y.floatValue;
+    case FlatType::Boolean:
+        return x.boolValue == y.boolValue;
+    case FlatType::String:
+        return a.getString(x) == b.getString(y);
+    case FlatType::Array:
+    case FlatType::List:
+    {
+        if (x.elements.length != y.elements.length)
+        {
+            return false;
+        }
+        const FlatValue* xElements = a.getElements(x);
+        const FlatValue* yElements = b.getElements(y);
+        for (uint32_t i = 0; i < x.elements.length; ++i)
+        {
+            if (!flatValuesEqual(a, xElements[i], b, yElements[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    default:
+        return true;
+    }
+}
+
+std::string getConfigFilepath(int station, int run, const std::string& directory)
+{
+    return directory + "/station" + std::to_string(station) + "/run" + std::to_string(run) + "/cfg/" + "acq.cfg";
+}
+
+std::mutex& getConfigBaseDirectoryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::shared_ptr<const std::string>& getConfigBaseDirectoryStorage()
+{
+    static std::shared_ptr<const std::string> baseDirectory = std::make_shared<const std::string>("/");
+    return baseDirectory;
+}
+
+void setConfigBaseDirectory(const std::string& baseDirectory)
+{
+    std::string directory = baseDirectory.empty() ? "/" : baseDirectory;
+    if (directory.back() != '/')
+    {
+        directory += '/';
+    }
+    std::shared_ptr<const std::string> storage = std::make_shared<const std::string>(std::move(directory));
+    std::lock_guard<std::mutex> lock(getConfigBaseDirectoryMutex());
+    getConfigBaseDirectoryStorage() = std::move(storage);
+}
+
+std::string getConfigBaseDirectory()
+{
+    std::lock_guard<std::mutex> lock(getConfigBaseDirectoryMutex());
+    return *getConfigBaseDirectoryStorage();
+}
+
+std::string resolveConfigPath(const std::string& path)
+{
+    if (!path.empty() && path[0] == '/')
+    {
+        return path;
+    }
+    std::shared_ptr<const std::string> baseDirectory;
+    {
+        std::lock_guard<std::mutex> lock(getConfigBaseDirectoryMutex());
+        baseDirectory = getConfigBaseDirectoryStorage();
+    }
+    return *baseDirectory + path;
+}
+
+bool parseConfigFile(const std::string& configFilepath, libconfig::Config& cfg)
+{
+    if (getConfigReadLimiter().getLimit() != 0)
+    {
+        // Only the read counts against the limit, the parse runs after releasing it
+        std::string contents;
+        if (!readFileContents(configFilepath, contents))
+        {
+            getConfigErrorLog().report(ConfigStatus::IOError, configFilepath);
+            return false;
+        }
+        return readConfigFromBuffer(contents.data(), contents.size(), cfg, configFilepath);
+    }
+    RNOG_CONFIG_TIME(parseNanoseconds);
+    RNOG_CONFIG_COUNT(filesParsed, 1);
+    const std::string resolvedFilepath = resolveConfigPath(configFilepath);
+    try
+    {
+        cfg.readFile(resolvedFilepath.c_str());
+    }
+    catch (const libconfig::FileIOException& fioex)
+    {
+        RNOG_CONFIG_COUNT(exceptions, 1);
+        getConfigErrorLog().report(ConfigStatus::IOError, configFilepath);
+        return false;
+    }
+    catch (const libconfig::ParseException& pex)
+    {
+        RNOG_CONFIG_COUNT(exceptions, 1);
+        getConfigErrorLog().report(ConfigStatus::ParseError, configFilepath, "line " + std::to_string(pex.getLine()) + " - " + pex.getError());
+        return false;
+    }
+#ifdef RNOG_CONFIG_INSTRUMENTATION
+    struct stat fileStat;
+    if (stat(resolvedFilepath.c_str(), &fileStat) == 0)
+    {
+        RNOG_CONFIG_COUNT(bytesRead, static_cast<uint64_t>(fileStat.st_size));
+    }
+#endif
+    return true;
+}
+
+bool readConfigFromBuffer(const char* data, size_t size, libconfig::Config& cfg, const std::string& source)
+{
+    RNOG_CONFIG_TIME(parseNanoseconds);
+    RNOG_CONFIG_COUNT(filesParsed, 1);
+    RNOG_CONFIG_COUNT(bytesRead, size);
+    try
+    {
+        if (size != 0 && data[size - 1] == '\0')
+        {
+            cfg.readString(data);
+        }
+        else
+        {
+            cfg.readString(std::string(data, size));
+        }
+    }
+    catch (const libconfig::ParseException& pex)
+    {
+        RNOG_CONFIG_COUNT(exceptions, 1);
+        getConfigErrorLog().report(ConfigStatus::ParseError, source, "line " + std::to_string(pex.getLine()) + " - " + pex.getError());
+        return false;
+    }
+    return true;
+}
+
+bool parseConfigFileMapped(const std::string& configFilepath, libconfig::Config& cfg)
+{
+    std::string resolvedFilepath = resolveConfigPath(configFilepath);
+    int fd = open(resolvedFilepath.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        getConfigErrorLog().report(ConfigStatus::IOError, configFilepath);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(fileStat.st_size);
+    if (size == 0)
+    {
+        close(fd);
+        return readConfigFromBuffer("", 1, cfg, configFilepath);
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, configFilepath);
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(mapping);
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    bool parsed = (size % pageSize != 0) ? readConfigFromBuffer(data, size + 1, cfg, configFilepath) : readConfigFromBuffer(data, size, cfg, configFilepath);
+    munmap(mapping, size);
+    return parsed;
+}
+
+timespec getModificationTime(const struct stat& fileStat)
+{
+#ifdef __APPLE__
+    return fileStat.st_mtimespec;
+#else
+    return fileStat.st_mtim;
+#endif
+}
+
+bool sameModificationTime(const timespec& a, const timespec& b)
+{
+    return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+std::shared_ptr<const libconfig::Config> ConfigCache::get(const std::string& path)
+{
+    const std::string configFilepath = resolveConfigPath(path);
+    struct stat fileStat;
+    bool haveStat = stat(configFilepath.c_str(), &fileStat) == 0;
+
+    if (haveStat)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(configFilepath);
+        if (it != index_.end())
+        {
+            Entry& entry = *it->second;
+            if (entry.size == fileStat.st_size && sameModificationTime(entry.mtime, getModificationTime(fileStat)))
+            {
+                ++stats_.hits;
+                RNOG_CONFIG_COUNT(cacheHits, 1);
+                lru_.splice(lru_.begin(), lru_, it->second);
+                return entry.config;
+            }
+            ++stats_.invalidations;
+            erase(it);
+        }
+        ++stats_.misses;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.misses;
+    }
+    RNOG_CONFIG_COUNT(cacheMisses, 1);
+
+    std::shared_ptr<libconfig::Config> config = std::make_shared<libconfig::Config>();
+    if (!parseConfigFile(configFilepath, *config))
+    {
+        return nullptr;
+    }
+    if (!haveStat)
+    {
+        return config;
+    }
+
+    Entry entry;
+    entry.path = configFilepath;
+    entry.size = fileStat.st_size;
+    entry.mtime = getModificationTime(fileStat);
+    entry.bytes = estimateBytes(fileStat.st_size);
+    entry.config = config;
+    insert(std::move(entry));
+    return config;
+}
+
+void ConfigCache::insert(Entry entry)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entry.bytes > maxBytes_)
+    {
+        return;
+    }
+    auto it = index_.find(entry.path);
+    if (it != index_.end())
+    {
+        erase(it);
+    }
+    stats_.bytes += entry.bytes;
+    lru_.push_front(std::move(entry));
+    index_[lru_.front().path] = lru_.begin();
+    stats_.entries = lru_.size();
+    evictToFit();
+}
+
+ConfigCache& getConfigCache()
+{
+    static ConfigCache cache;
+    return cache;
+}
+
+void readConfigFile(int station, int run, const std::string& directory, const std::string& configSettingPath)
+{
+    RNOG_CONFIG_COUNT(readConfigFileCalls, 1);
+    RNOG_CONFIG_TIME_RUN(readConfigFileNanoseconds, station, run);
+    std::shared_ptr<const libconfig::Config> cfg = getConfigCache().get(getConfigFilepath(station, run, directory));
+    if (!cfg)
+    {
+        return;
+    }
+    std::string value_f = getCommonSettingValue(*cfg, configSettingPath);
+    std::cout << configSettingPath << " : " << value_f << std::endl;
+}
+
+std::unordered_map<std::string, std::string> readConfigFile(int station, int run, const std::string& directory, const std::vector<std::string>& configSettingPaths)
+{
+    RNOG_CONFIG_COUNT(readConfigFileCalls, 1);
+    RNOG_CONFIG_TIME_RUN(readConfigFileNanoseconds, station, run);
+    std::unordered_map<std::string, std::string> values;
+    std::shared_ptr<const libconfig::Config> cfg = getConfigCache().get(getConfigFilepath(station, run, directory));
+    if (!cfg)
+    {
+        return values;
+    }
+    values.reserve(configSettingPaths.size());
+    for (const std::string& configSettingPath : configSettingPaths)
+    {
+        values[configSettingPath] = getCommonSettingValue(*cfg, configSettingPath);
+    }
+    return values;
+}
+
+std::unordered_map<std::string, std::string> readConfigFile(int station, int run, const std::string& directory, std::initializer_list<std::string> configSettingPaths)
+{
+    return readConfigFile(station, run, directory, std::vector<std::string>(configSettingPaths));
+}
+
+void parallelFor(size_t count, unsigned int nThreads, const std::function<void(size_t)>& task)
+{
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = static_cast<unsigned int>(std::min<size_t>(nThreads, count));
+    if (nThreads <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    // The block of indices left to each thread, on its own cache line. Changes hold the mutex, thieves peek at the bounds without it.
+    struct alignas(64) Block
+    {
+        std::mutex mutex;
+        std::atomic<size_t> begin{0};
+        std::atomic<size_t> end{0};
+    };
+    std::unique_ptr<Block[]> blocks(new Block[nThreads]);
+    for (unsigned int t = 0; t < nThreads; ++t)
+    {
+        blocks[t].begin.store(count * t / nThreads, std::memory_order_relaxed);
+        blocks[t].end.store(count * (t + 1) / nThreads, std::memory_order_relaxed);
+    }
+
+    auto steal = [&](unsigned int thief)
+    {
+        for (;;)
+        {
+            // Pick the largest block without locking, then check it under its lock
+            unsigned int victim = thief;
+            size_t largest = 0;
+            for (unsigned int t = 0; t < nThreads; ++t)
+            {
+                const size_t begin = blocks[t].begin.load(std::memory_order_relaxed);
+                const size_t end = blocks[t].end.load(std::memory_order_relaxed);
+                if (t != thief && end > begin && end - begin > largest)
+                {
+                    victim = t;
+                    largest = end - begin;
+                }
+            }
+            if (victim == thief)
+            {
+                return false;
+            }
+            size_t begin;
+            size_t end;
+            {
+                std::lock_guard<std::mutex> lock(blocks[victim].mutex);
+                if (blocks[victim].begin >= blocks[victim].end)
+                {
+                    continue;
+                }
+                end = blocks[victim].end;
+                begin = blocks[victim].begin + (end - blocks[victim].begin) / 2;
+                blocks[victim].end = begin;
+            }
+            std::lock_guard<std::mutex> lock(blocks[thief].mutex);
+            blocks[thief].begin = begin;
+            blocks[thief].end = end;
+            return true;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads);
+    for (unsigned int t = 0; t < nThreads; ++t)
+    {
+        workers.emplace_back([&, t]()
+        {
+            Block& own = blocks[t];
+            for (;;)
+            {
+                size_t i;
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    i = own.begin < own.end ? own.begin++ : count;
+                }
+                if (i < count)
+                {
+                    task(i);
+                }
+                else if (!steal(t))
+                {
+                    return;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+ConfigReadLimiter& getConfigReadLimiter()
+{
+    static ConfigReadLimiter limiter;
+    return limiter;
+}
+
+bool parseNumberedName(const std::string& name, const std::string& prefix, int& number)
+{
+    if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+    {
+        return false;
+    }
+    // getConfigFilepath writes numbers without leading zeros, so "run0327" would be read as run 327 but found at run327
+    if (name[prefix.size()] == '0' && name.size() > prefix.size() + 1)
+    {
+        return false;
+    }
+    number = 0;
+    for (size_t i = prefix.size(); i < name.size(); ++i)
+    {
+        if (name[i] < '0' || name[i] > '9')
+        {
+            return false;
+        }
+        const int digit = name[i] - '0';
+        if (number > (std::numeric_limits<int>::max() - digit) / 10)
+        {
+            return false;
+        }
+        number = number * 10 + digit;
+    }
+    return true;
+}
+
+std::vector<std::pair<int, std::string>> listNumberedDirectories(const std::string& directory, const std::string& prefix)
+{
+    std::vector<std::pair<int, std::string>> entries;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, directory, std::strerror(errno));
+        return entries;
+    }
+    while (dirent* entry = readdir(dir))
+    {
+        int number;
+        if (parseNumberedName(entry->d_name, prefix, number))
+        {
+            entries.emplace_back(number, entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+std::vector<ConfigRun> findConfigRuns(const std::string& directory)
+{
+    std::vector<ConfigRun> runs;
+    std::string root = resolveConfigPath(directory);
+    for (const auto& stationDir : listNumberedDirectories(root, "station"))
+    {
+        for (const auto& runDir : listNumberedDirectories(root + "/" + stationDir.second, "run"))
+        {
+            std::string configFilepath = getConfigFilepath(stationDir.first, runDir.first, root);
+            struct stat fileStat;
+            if (stat(configFilepath.c_str(), &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+            {
+                runs.push_back(ConfigRun{stationDir.first, runDir.first});
+            }
+        }
+    }
+    return runs;
+}
+
+std::vector<RunConfigValues> scanConfigFiles(const std::string& directory, const std::vector<ConfigRun>& runs, const std::vector<std::string>& configSettingPaths, unsigned int nThreads)
+{
+    std::string root = resolveConfigPath(directory);
+    std::vector<RunConfigValues> results(runs.size());
+    parallelFor(runs.size(), nThreads, [&](size_t i)
+    {
+        RunConfigValues& result = results[i];
+        result.station = runs[i].station;
+        result.run = runs[i].run;
+        std::shared_ptr<const libconfig::Config> cfg = getConfigCache().get(getConfigFilepath(result.station, result.run, root));
+        if (!cfg)
+        {
+            return;
+        }
+        result.parsed = true;
+        result.values.reserve(configSettingPaths.size());
+        for (const std::string& configSettingPath : configSettingPaths)
+        {
+            result.values.push_back(getCommonSettingValue(*cfg, configSettingPath));
+        }
+    });
+    return results;
+}
+
+std::vector<RunConfigValues> scanConfigFiles(const std::string& directory, const std::vector<std::string>& configSettingPaths, unsigned int nThreads)
+{
+    return scanConfigFiles(directory, findConfigRuns(directory), configSettingPaths, nThreads);
+}
+
+void printConfigTable(const std::vector<RunConfigValues>& results, const std::vector<std::string>& configSettingPaths, std::ostream& out)
+{
+    out << "station\trun";
+    for (const std::string& configSettingPath : configSettingPaths)
+    {
+        out << "\t" << configSettingPath;
+    }
+    out << "\n";
+    for (const RunConfigValues& result : results)
+    {
+        out << result.station << "\t" << result.run;
+        for (size_t i = 0; i < configSettingPaths.size(); ++i)
+        {
+            std::string value = i < result.values.size() ? result.values[i] : "";
+            std::replace(value.begin(), value.end(), '\n', ' ');
+            out << "\t" << value;
+        }
+        out << "\n";
+    }
+    out.flush();
+}
+
+std::shared_ptr<const libconfig::Config> ConfigPrefetcher::get(int station, int run)
+{
+    auto position = positions_.find(key(station, run));
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (position == positions_.end() || position->second < consumed_)
+    {
+        lock.unlock();
+        return getConfigCache().get(getConfigFilepath(station, run, directory_));
+    }
+
+    consumed_ = position->second;
+    while (!ready_.empty() && ready_.front().first < consumed_)
+    {
+        ready_.pop_front();
+    }
+    spaceAvailable_.notify_one();
+    configReady_.wait(lock, [&]() { return !ready_.empty(); });
+    std::shared_ptr<const libconfig::Config> config = std::move(ready_.front().second);
+    ready_.pop_front();
+    ++consumed_;
+    lock.unlock();
+    spaceAvailable_.notify_one();
+    return config;
+}
+
+void ConfigPrefetcher::prefetch()
+{
+    for (size_t i = 0; i < runs_.size(); ++i)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            spaceAvailable_.wait(lock, [&]() { return stop_ || i < consumed_ + depth_; });
+            if (stop_)
+            {
+                return;
+            }
+            // Continue from the run the consumer asked for if it skipped ahead.
+            i = std::max(i, consumed_);
+            if (i >= runs_.size())
+            {
+                return;
+            }
+        }
+        std::shared_ptr<const libconfig::Config> config = getConfigCache().get(getConfigFilepath(runs_[i].station, runs_[i].run, directory_));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (i < consumed_)
+            {
+                // The consumer skipped this run while it was being read.
+                continue;
+            }
+            ready_.emplace_back(i, std::move(config));
+        }
+        configReady_.notify_one();
+    }
+}
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat fileStat;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    return std::make_shared<const MappedFile>(data, static_cast<size_t>(fileStat.st_size));
+}
+
+bool ConfigSnapshot::open(const std::string& snapshotPath)
+{
+    runs_.clear();
+    std::shared_ptr<const MappedFile> mapping = MappedFile::open(resolveConfigPath(snapshotPath));
+    if (!mapping)
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, snapshotPath);
+        return false;
+    }
+    if (!load(mapping))
+    {
+        runs_.clear();
+        getConfigErrorLog().report(ConfigStatus::InvalidFormat, snapshotPath, "not a valid configuration snapshot");
+        return false;
+    }
+    return true;
+}
+
+const SnapshotRun* ConfigSnapshot::find(int station, int run) const
+{
+    auto it = std::lower_bound(runs_.begin(), runs_.end(), std::make_pair(station, run), [](const SnapshotRun& a, const std::pair<int, int>& b)
+    {
+        return std::make_pair(a.station, a.run) < b;
+    });
+    if (it != runs_.end() && it->station == station && it->run == run)
+    {
+        return &*it;
+    }
+    return nullptr;
+}
+
+bool ConfigSnapshot::load(const std::shared_ptr<const MappedFile>& mapping)
+{
+    const char* data = mapping->getData();
+    const size_t size = mapping->getSize();
+    if (size < sizeof(SnapshotHeader))
+    {
+        return false;
+    }
+    const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(data);
+    if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0 || header.version != snapshotVersion ||
+        header.byteOrder != snapshotByteOrder || !inBounds<SnapshotRunRecord>(header.runsOffset, header.runCount, size) ||
+        !inBounds<char>(header.stringsOffset, header.stringsSize, size) || header.stringsSize > std::numeric_limits<uint32_t>::max())
+    {
+        return false;
+    }
+
+    const SnapshotRunRecord* records = reinterpret_cast<const SnapshotRunRecord*>(data + header.runsOffset);
+    const char* strings = data + header.stringsOffset;
+    runs_.reserve(header.runCount);
+    for (uint64_t i = 0; i < header.runCount; ++i)
+    {
+        const SnapshotRunRecord& record = records[i];
+        if (!inBounds<FlatSetting>(record.settingsOffset, record.settingsCount, size) ||
+            !inBounds<uint32_t>(record.sortedOffset, record.settingsCount, size) ||
+            !inBounds<FlatValue>(record.elementsOffset, record.elementsCount, size))
+        {
+            return false;
+        }
+        const FlatSetting* settings = reinterpret_cast<const FlatSetting*>(data + record.settingsOffset);
+        const uint32_t* sorted = reinterpret_cast<const uint32_t*>(data + record.sortedOffset);
+        const FlatValue* elements = reinterpret_cast<const FlatValue*>(data + record.elementsOffset);
+        for (uint32_t j = 0; j < record.settingsCount; ++j)
+        {
+            const FlatSetting& setting = settings[j];
+            if (sorted[j] >= record.settingsCount || setting.end <= j || setting.end > record.settingsCount ||
+                !validRange(FlatValue::Range{setting.pathOffset, setting.pathLength}, header.stringsSize) || setting.nameOffset > setting.pathLength ||
+                !validValue(setting.value, header.stringsSize, record.elementsCount))
+            {
+                return false;
+            }
+        }
+        for (uint32_t j = 0; j < record.elementsCount; ++j)
+        {
+            if (!validValue(elements[j], header.stringsSize, 0))
+            {
+                return false;
+            }
+        }
+        if (i != 0 && std::make_pair(records[i - 1].station, records[i - 1].run) >= std::make_pair(record.station, record.run))
+        {
+            return false;
+        }
+
+        SnapshotRun run;
+        run.station = record.station;
+        run.run = record.run;
+        run.mtime.tv_sec = static_cast<time_t>(record.mtimeSeconds);
+        run.mtime.tv_nsec = static_cast<long>(record.mtimeNanoseconds);
+        run.fileSize = record.fileSize;
+        run.config = FlatConfig(mapping, settings, record.settingsCount, sorted, elements, record.elementsCount, strings, static_cast<uint32_t>(header.stringsSize));
+        runs_.push_back(std::move(run));
+    }
+    return true;
+}
+
+bool ConfigSnapshot::validValue(const FlatValue& value, uint64_t stringsSize, uint64_t elementsCount)
+{
+    switch (value.type)
+    {
+    case FlatType::String:
+        return validRange(value.text, stringsSize);
+    case FlatType::Array:
+    case FlatType::List:
+        return validRange(value.elements, elementsCount);
+    default:
+        return value.type <= FlatType::List;
+    }
+}
+
+InternedFlatTables internFlatConfigs(const std::vector<SnapshotRun>& runs)
+{
+    InternedFlatTables tables;
+    std::string& strings = tables.strings;
+    std::unordered_map<std::string_view, uint32_t> interned;
+    auto intern = [&](std::string_view text) -> uint32_t
+    {
+        auto it = interned.find(text);
+        if (it != interned.end())
+        {
+            return it->second;
+        }
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(text.data(), text.size());
+        interned.emplace(text, offset);
+        return offset;
+    };
+
+    tables.settings.resize(runs.size());
+    tables.elements.resize(runs.size());
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const FlatConfig& config = runs[i].config;
+        tables.settings[i].assign(config.getSettingsData(), config.getSettingsData() + config.size());
+        tables.elements[i].assign(config.getElementsData(), config.getElementsData() + config.getElementsSize());
+        for (FlatSetting& setting : tables.settings[i])
+        {
+            std::string_view path = config.getPath(setting);
+            setting.pathOffset = intern(path);
+            if (setting.value.type == FlatType::String)
+            {
+                setting.value.text.offset = intern(config.getString(setting.value));
+            }
+        }
+        for (FlatValue& element : tables.elements[i])
+        {
+            if (element.type == FlatType::String)
+            {
+                element.text.offset = intern(config.getString(element));
+            }
+        }
+    }
+    return tables;
+}
+
+bool writeConfigSnapshot(const std::string& snapshotPath, std::vector<SnapshotRun> runs)
+{
+    std::stable_sort(runs.begin(), runs.end(), [](const SnapshotRun& a, const SnapshotRun& b)
+    {
+        return std::make_pair(a.station, a.run) < std::make_pair(b.station, b.run);
+    });
+    runs.erase(std::unique(runs.begin(), runs.end(), [](const SnapshotRun& a, const SnapshotRun& b)
+    {
+        return a.station == b.station && a.run == b.run;
+    }), runs.end());
+
+    InternedFlatTables tables = internFlatConfigs(runs);
+    const std::string& strings = tables.strings;
+    const std::vector<std::vector<FlatSetting>>& settingTables = tables.settings;
+    const std::vector<std::vector<FlatValue>>& elementTables = tables.elements;
+
+    auto align = [](uint64_t offset) { return (offset + 7) & ~uint64_t(7); };
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = snapshotVersion;
+    header.byteOrder = snapshotByteOrder;
+    header.runCount = runs.size();
+    header.runsOffset = sizeof(SnapshotHeader);
+
+    std::vector<SnapshotRunRecord> records(runs.size());
+    uint64_t offset = header.runsOffset + runs.size() * sizeof(SnapshotRunRecord);
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        SnapshotRunRecord& record = records[i];
+        record.station = runs[i].station;
+        record.run = runs[i].run;
+        record.mtimeSeconds = runs[i].mtime.tv_sec;
+        record.mtimeNanoseconds = runs[i].mtime.tv_nsec;
+        record.fileSize = runs[i].fileSize;
+        record.settingsCount = static_cast<uint32_t>(settingTables[i].size());
+        record.elementsCount = static_cast<uint32_t>(elementTables[i].size());
+        record.settingsOffset = offset;
+        offset += record.settingsCount * sizeof(FlatSetting);
+        record.sortedOffset = offset;
+        offset = align(offset + record.settingsCount * sizeof(uint32_t));
+        record.elementsOffset = offset;
+        offset += record.elementsCount * sizeof(FlatValue);
+    }
+    header.stringsOffset = offset;
+    header.stringsSize = strings.size();
+
+    const std::string resolvedPath = resolveConfigPath(snapshotPath);
+    const std::string temporaryPath = resolvedPath + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    const char padding[8] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(SnapshotRunRecord));
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const uint32_t* sorted = runs[i].config.getSortedData();
+        out.write(reinterpret_cast<const char*>(settingTables[i].data()), settingTables[i].size() * sizeof(FlatSetting));
+        out.write(reinterpret_cast<const char*>(sorted), settingTables[i].size() * sizeof(uint32_t));
+        out.write(padding, records[i].elementsOffset - (records[i].sortedOffset + settingTables[i].size() * sizeof(uint32_t)));
+        out.write(reinterpret_cast<const char*>(elementTables[i].data()), elementTables[i].size() * sizeof(FlatValue));
+    }
+    out.write(strings.data(), strings.size());
+    out.close();
+    if (!out || std::rename(temporaryPath.c_str(), resolvedPath.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        getConfigErrorLog().report(ConfigStatus::IOError, snapshotPath, "cannot write snapshot");
+        return false;
+    }
+    return true;
+}
+
+int updateConfigSnapshot(const std::string& snapshotPath, const std::string& directory, unsigned int nThreads)
+{
+    ConfigSnapshot previous;
+    struct stat snapshotStat;
+    if (stat(resolveConfigPath(snapshotPath).c_str(), &snapshotStat) == 0)
+    {
+        previous.open(snapshotPath);
+    }
+
+    const std::string root = resolveConfigPath(directory);
+    const std::vector<ConfigRun> configRuns = findConfigRuns(root);
+    std::vector<SnapshotRun> runs(configRuns.size());
+    std::vector<char> valid(configRuns.size(), 0);
+    std::atomic<int> parsed(0);
+    parallelFor(configRuns.size(), nThreads, [&](size_t i)
+    {
+        SnapshotRun& run = runs[i];
+        run.station = configRuns[i].station;
+        run.run = configRuns[i].run;
+        const std::string configFilepath = getConfigFilepath(run.station, run.run, root);
+        struct stat fileStat;
+        if (stat(configFilepath.c_str(), &fileStat) != 0)
+        {
+            return;
+        }
+        run.mtime = getModificationTime(fileStat);
+        run.fileSize = static_cast<uint64_t>(fileStat.st_size);
+
+        const SnapshotRun* previousRun = previous.find(run.station, run.run);
+        if (previousRun && previousRun->fileSize == run.fileSize && sameModificationTime(previousRun->mtime, run.mtime))
+        {
+            run.config = previousRun->config;
+            valid[i] = 1;
+            return;
+        }
+        libconfig::Config cfg;
+        if (parseConfigFile(configFilepath, cfg))
+        {
+            run.config = flattenConfig(cfg);
+            valid[i] = 1;
+            ++parsed;
+        }
+    });
+
+    std::vector<SnapshotRun> validRuns;
+    validRuns.reserve(runs.size());
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        if (valid[i])
+        {
+            validRuns.push_back(std::move(runs[i]));
+        }
+    }
+    if (!writeConfigSnapshot(snapshotPath, std::move(validRuns)))
+    {
+        return -1;
+    }
+    return parsed;
+}
+
+std::string resolveColumnPath(const std::string& alias)
+{
+    if (alias.find(".") != std::string::npos)
+    {
+        return alias;
+    }
+    std::string_view path = resolveCommonSettingAlias(alias);
+    if (path.empty())
+    {
+        getConfigErrorLog().report(ConfigStatus::UnknownAlias, alias);
+    }
+    return std::string(path);
+}
+
+uint64_t hashConfigContent(const char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool readFileContents(const std::string& path, std::string& contents)
+{
+    ConfigReadGuard guard;
+    std::ifstream in(resolveConfigPath(path), std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    contents.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0, std::ios::beg);
+    in.read(&contents[0], contents.size());
+    return static_cast<bool>(in);
+}
+
+bool ConfigStore::add(int station, int run, const char* data, size_t size)
+{
+    const uint64_t hash = hashConfigContent(data, size);
+    const std::string_view text(data, size);
+    // The hash only narrows the search, contents are shared when their text is the same
+    auto range = contents_.equal_range(hash);
+    auto content = std::find_if(range.first, range.second, [text](const std::pair<const uint64_t, StoredContent>& entry)
+    {
+        return entry.second.stored->text == text;
+    });
+    if (content == range.second)
+    {
+        libconfig::Config cfg;
+        if (!readConfigFromBuffer(data, size, cfg, "station" + std::to_string(station) + "/run" + std::to_string(run)))
+        {
+            return false;
+        }
+        content = contents_.emplace(hash, StoredContent{store(flattenConfig(cfg), text, station, run), 0});
+    }
+    ++content->second.runs;
+
+    const Key key(station, run);
+    auto it = runs_.find(key);
+    if (it == runs_.end())
+    {
+        it = runs_.emplace(key, StoredRun()).first;
+    }
+    else
+    {
+        release(it->second);
+    }
+    it->second.hash = hash;
+    it->second.stored = content->second.stored;
+    updateChangedPaths(it);
+    auto next = std::next(it);
+    if (next != runs_.end() && next->first.first == station)
+    {
+        updateChangedPaths(next);
+    }
+    return true;
+}
+
+void ConfigStore::release(const StoredRun& run)
+{
+    auto range = contents_.equal_range(run.hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second.stored == run.stored)
+        {
+            if (--it->second.runs == 0)
+            {
+                contents_.erase(it);
+            }
+            return;
+        }
+    }
+}
+
+ConfigStoreValue ConfigStore::find(int station, int run, std::string_view path) const
+{
+    ConfigStoreValue value;
+    auto it = runs_.find(Key(station, run));
+    if (it == runs_.end())
+    {
+        return value;
+    }
+    const StoredConfig& stored = *it->second.stored;
+    const FlatSetting* setting = stored.base.find(path);
+    if (!setting)
+    {
+        return value;
+    }
+    value.config = &stored.base;
+    value.setting = setting;
+    auto delta = std::lower_bound(stored.deltaIndices.begin(), stored.deltaIndices.end(), stored.base.indexOf(*setting));
+    if (delta != stored.deltaIndices.end() && *delta == stored.base.indexOf(*setting))
+    {
+        value.config = &stored.delta;
+        value.setting = &stored.delta[delta - stored.deltaIndices.begin()];
+    }
+    return value;
+}
+
+FlatConfig ConfigStore::getConfig(int station, int run) const
+{
+    auto it = runs_.find(Key(station, run));
+    if (it == runs_.end())
+    {
+        return FlatConfig();
+    }
+    const StoredConfig& stored = *it->second.stored;
+    if (stored.deltaIndices.empty())
+    {
+        return stored.base;
+    }
+
+    const FlatConfig& base = stored.base;
+    std::shared_ptr<FlatConfigTables> tables = std::make_shared<FlatConfigTables>();
+    tables->settings.assign(base.getSettingsData(), base.getSettingsData() + base.size());
+    tables->sorted.assign(base.getSortedData(), base.getSortedData() + base.size());
+    tables->elements.assign(base.getElementsData(), base.getElementsData() + base.getElementsSize());
+    tables->strings.assign(base.getStringsData(), base.getStringsSize());
+    for (size_t i = 0; i < stored.deltaIndices.size(); ++i)
+    {
+        tables->settings[stored.deltaIndices[i]].value = tables->copyValue(stored.delta, stored.delta[i].value);
+    }
+    return FlatConfigTables::makeFlatConfig(std::move(tables));
+}
+
+std::vector<ConfigRun> ConfigStore::runsWhereSettingChanged(std::string_view path) const
+{
+    // Whether a changed path matches is decided once per distinct path, the runs only compare IDs
+    const SettingPathPool& pool = getSettingPathPool();
+    std::unordered_map<SettingPathId, bool> matches;
+    std::vector<ConfigRun> runs;
+    for (const auto& entry : runs_)
+    {
+        for (SettingPathId id : entry.second.changedPaths)
+        {
+            auto match = matches.find(id);
+            if (match == matches.end())
+            {
+                std::string_view changed = pool.getPath(id);
+                match = matches.emplace(id, changed.compare(0, path.size(), path) == 0 && (changed.size() == path.size() || changed[path.size()] == '.')).first;
+            }
+            if (match->second)
+            {
+                runs.push_back(ConfigRun{entry.first.first, entry.first.second});
+                break;
+            }
+        }
+    }
+    return runs;
+}
+
+std::shared_ptr<const ConfigStore::StoredConfig> ConfigStore::store(FlatConfig config, std::string_view text, int station, int run)
+{
+    std::shared_ptr<StoredConfig> stored = std::make_shared<StoredConfig>();
+    stored->text = text;
+
+    const FlatConfig* base = nullptr;
+    auto neighbour = runs_.lower_bound(Key(station, run));
+    if (neighbour != runs_.begin() && std::prev(neighbour)->first.first == station)
+    {
+        base = &std::prev(neighbour)->second.stored->base;
+    }
+    else if (neighbour != runs_.end() && neighbour->first.first == station)
+    {
+        base = &neighbour->second.stored->base;
+    }
+
+    std::vector<uint32_t> changed;
+    if (base && sameStructure(*base, config, changed) && changed.size() <= maxDeltaFraction_ * config.size())
+    {
+        std::shared_ptr<FlatConfigTables> tables = std::make_shared<FlatConfigTables>();
+        for (uint32_t index : changed)
+        {
+            tables->addCopy(config, config[index]);
+        }
+        tables->sortIndex();
+        stored->base = *base;
+        stored->delta = FlatConfigTables::makeFlatConfig(std::move(tables));
+        stored->deltaIndices = std::move(changed);
+    }
+    else
+    {
+        stored->base = std::move(config);
+    }
+    return stored;
+}
+
+bool ConfigStore::sameStructure(const FlatConfig& base, const FlatConfig& config, std::vector<uint32_t>& changed)
+{
+    if (base.size() != config.size())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < config.size(); ++i)
+    {
+        if (base[i].end != config[i].end || !sameFlatPath(base, base[i], config, config[i]))
+        {
+            return false;
+        }
+        if (!flatValuesEqual(base, base[i].value, config, config[i].value))
+        {
+            changed.push_back(i);
+        }
+    }
+    return true;
+}
+
+void ConfigStore::updateChangedPaths(std::map<Key, StoredRun>::iterator it)
+{
+    StoredRun& current = it->second;
+    current.changedPaths.clear();
+    if (it == runs_.begin() || std::prev(it)->first.first != it->first.first)
+    {
+        return;
+    }
+    const StoredRun& previous = std::prev(it)->second;
+    if (previous.hash == current.hash)
+    {
+        return;
+    }
+    FlatConfig previousConfig = getConfig(std::prev(it)->first.first, std::prev(it)->first.second);
+    FlatConfig currentConfig = getConfig(it->first.first, it->first.second);
+    SettingPathPool& pool = getSettingPathPool();
+    forEachChangedPath(previousConfig, currentConfig, [&current, &pool](std::string_view path)
+    {
+        current.changedPaths.push_back(pool.intern(path));
+    });
+}
+
+bool pathMatches(std::string_view path, const std::vector<std::string>& filters)
+{
+    if (filters.empty())
+    {
+        return true;
+    }
+    for (const std::string& filter : filters)
+    {
+        if (path.compare(0, filter.size(), filter) == 0 && (path.size() == filter.size() || path[filter.size()] == '.'))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void diffConfigs(const FlatConfig& before, const FlatConfig& after, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed)
+{
+    std::vector<std::string> filters;
+    filters.reserve(paths.size());
+    for (const std::string& path : paths)
+    {
+        std::string_view resolved = path.find('.') == std::string::npos ? resolveCommonSettingAlias(path) : std::string_view();
+        filters.emplace_back(resolved.empty() ? std::string_view(path) : resolved);
+    }
+
+    ConfigChange change;
+    diffFlatConfigs(before, after, [&](const FlatSetting* x, const FlatSetting* y)
+    {
+        std::string_view path = x ? before.getPath(*x) : after.getPath(*y);
+        if (!pathMatches(path, filters))
+        {
+            return;
+        }
+        change.kind = !x ? ConfigChangeKind::Added : (!y ? ConfigChangeKind::Removed : ConfigChangeKind::Modified);
+        change.path.assign(path.data(), path.size());
+        change.oldValue.clear();
+        change.newValue.clear();
+        if (x)
+        {
+            appendFlatValue(change.oldValue, before, x->value);
+        }
+        if (y)
+        {
+            appendFlatValue(change.newValue, after, y->value);
+        }
+        changed(change);
+    });
+}
+
+void diffConfigs(const libconfig::Config& before, const libconfig::Config& after, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed)
+{
+    diffConfigs(flattenConfig(before), flattenConfig(after), paths, changed);
+}
+
+void streamConfigChanges(const std::string& directory, std::vector<ConfigRun> runs, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed)
+{
+    std::sort(runs.begin(), runs.end(), [](const ConfigRun& a, const ConfigRun& b)
+    {
+        return std::make_pair(a.station, a.run) < std::make_pair(b.station, b.run);
+    });
+
+    FlatConfig previous;
+    ConfigRun previousRun = {0, 0};
+    bool havePrevious = false;
+    for (const ConfigRun& run : runs)
+    {
+        libconfig::Config cfg;
+        if (!parseConfigFile(getConfigFilepath(run.station, run.run, directory), cfg))
+        {
+            continue;
+        }
+        FlatConfig current = flattenConfig(cfg);
+        if (havePrevious && previousRun.station == run.station)
+        {
+            diffConfigs(previous, current, paths, [&](const ConfigChange& change)
+            {
+                ConfigChange record = change;
+                record.station = run.station;
+                record.previousRun = previousRun.run;
+                record.run = run.run;
+                changed(record);
+            });
+        }
+        previous = std::move(current);
+        previousRun = run;
+        havePrevious = true;
+    }
+}
+
+void streamConfigChanges(int station, int firstRun, int lastRun, const std::string& directory, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed)
+{
+    const std::string root = resolveConfigPath(directory);
+    std::vector<ConfigRun> runs;
+    for (const auto& runDir : listNumberedDirectories(root + "/station" + std::to_string(station), "run"))
+    {
+        if (runDir.first >= firstRun && runDir.first <= lastRun)
+        {
+            runs.push_back(ConfigRun{station, runDir.first});
+        }
+    }
+    streamConfigChanges(root, std::move(runs), paths, changed);
+}
+
+const ConfigLocation* ConfigLocationIndex::find(int station, int run) const
+{
+    auto it = std::lower_bound(locations_.begin(), locations_.end(), std::make_pair(station, run), [](const ConfigLocation& a, const std::pair<int, int>& b)
+    {
+        return std::make_pair(a.station, a.run) < b;
+    });
+    if (it != locations_.end() && it->station == station && it->run == run)
+    {
+        return &*it;
+    }
+    return nullptr;
+}
+
+int ConfigLocationIndex::update(const std::string& directory, bool verifyFiles, unsigned int nThreads)
+{
+    const std::string root = resolveConfigPath(directory);
+    if (root != directory_)
+    {
+        locations_.clear();
+        stations_.clear();
+        pending_.clear();
+        directory_ = root;
+    }
+
+    std::vector<ConfigLocation> candidates;
+    std::vector<char> known;
+    std::map<int, timespec> stations;
+    int changes = 0;
+    for (const auto& stationDir : listNumberedDirectories(root, "station"))
+    {
+        const int station = stationDir.first;
+        const std::string stationPath = root + "/" + stationDir.second;
+        struct stat stationStat;
+        if (stat(stationPath.c_str(), &stationStat) != 0 || !S_ISDIR(stationStat.st_mode))
+        {
+            continue;
+        }
+        stations[station] = getModificationTime(stationStat);
+        auto previousStation = stations_.find(station);
+        const bool unchanged = previousStation != stations_.end() && sameModificationTime(previousStation->second, stations[station]);
+        if (unchanged)
+        {
+            for (const ConfigLocation& location : locations_)
+            {
+                if (location.station == station)
+                {
+                    candidates.push_back(location);
+                    known.push_back(!verifyFiles);
+                }
+            }
+            // Writing a configuration file into an existing run directory does not touch the station directory, so stat those again
+            for (auto it = pending_.lower_bound({station, std::numeric_limits<int>::min()}); it != pending_.end() && it->first == station; ++it)
+            {
+                ConfigLocation location;
+                location.station = station;
+                location.run = it->second;
+                location.path = getConfigFilepath(station, it->second, root);
+                candidates.push_back(std::move(location));
+                known.push_back(0);
+            }
+            continue;
+        }
+        for (const auto& runDir : listNumberedDirectories(stationPath, "run"))
+        {
+            ConfigLocation location;
+            location.station = station;
+            location.run = runDir.first;
+            location.path = getConfigFilepath(station, runDir.first, root);
+            candidates.push_back(std::move(location));
+            known.push_back(0);
+        }
+    }
+
+    // Stat the files of changed stations, and hash them if they are new or changed
+    std::vector<char> present(candidates.size(), 0);
+    std::atomic<int> modified(0);
+    parallelFor(candidates.size(), nThreads, [&](size_t i)
+    {
+        ConfigLocation& location = candidates[i];
+        if (known[i])
+        {
+            present[i] = 1;
+            return;
+        }
+        struct stat fileStat;
+        if (stat(location.path.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+        {
+            return;
+        }
+        present[i] = 1;
+        const ConfigLocation* previous = find(location.station, location.run);
+        location.size = static_cast<uint64_t>(fileStat.st_size);
+        location.mtime = getModificationTime(fileStat);
+        if (previous && previous->size == location.size && sameModificationTime(previous->mtime, location.mtime))
+        {
+            location.hash = previous->hash;
+            return;
+        }
+        std::string contents;
+        if (!readFileContents(location.path, contents))
+        {
+            present[i] = 0;
+            return;
+        }
+        location.hash = hashConfigContent(contents.data(), contents.size());
+        if (!previous || previous->hash != location.hash)
+        {
+            ++modified;
+        }
+    });
+
+    std::vector<ConfigLocation> locations;
+    std::set<std::pair<int, int>> pending;
+    locations.reserve(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (present[i])
+        {
+            locations.push_back(std::move(candidates[i]));
+        }
+        else
+        {
+            pending.insert({candidates[i].station, candidates[i].run});
+        }
+    }
+    std::sort(locations.begin(), locations.end(), [](const ConfigLocation& a, const ConfigLocation& b)
+    {
+        return std::make_pair(a.station, a.run) < std::make_pair(b.station, b.run);
+    });
+    for (const ConfigLocation& location : locations_)
+    {
+        auto it = std::lower_bound(locations.begin(), locations.end(), std::make_pair(location.station, location.run), [](const ConfigLocation& a, const std::pair<int, int>& b)
+        {
+            return std::make_pair(a.station, a.run) < b;
+        });
+        if (it == locations.end() || it->station != location.station || it->run != location.run)
+        {
+            ++changes;
+        }
+    }
+    changes += modified;
+    locations_ = std::move(locations);
+    stations_ = std::move(stations);
+    pending_ = std::move(pending);
+    return changes;
+}
+
+bool ConfigLocationIndex::updateRun(int station, int run, ConfigChangeKind& kind)
+{
+    if (directory_.empty())
+    {
+        return false;
+    }
+    auto it = std::lower_bound(locations_.begin(), locations_.end(), std::make_pair(station, run), [](const ConfigLocation& a, const std::pair<int, int>& b)
+    {
+        return std::make_pair(a.station, a.run) < b;
+    });
+    const bool indexed = it != locations_.end() && it->station == station && it->run == run;
+
+    ConfigLocation location;
+    location.station = station;
+    location.run = run;
+    location.path = getConfigFilepath(station, run, directory_);
+    struct stat fileStat;
+    std::string contents;
+    const bool present = stat(location.path.c_str(), &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+    if (present)
+    {
+        location.size = static_cast<uint64_t>(fileStat.st_size);
+        location.mtime = getModificationTime(fileStat);
+        if (indexed && it->size == location.size && sameModificationTime(it->mtime, location.mtime))
+        {
+            return false;
+        }
+    }
+    if (!present || !readFileContents(location.path, contents))
+    {
+        pending_.insert({station, run});
+        if (!indexed)
+        {
+            return false;
+        }
+        locations_.erase(it);
+        kind = ConfigChangeKind::Removed;
+        return true;
+    }
+    pending_.erase({station, run});
+    location.hash = hashConfigContent(contents.data(), contents.size());
+    if (!indexed)
+    {
+        locations_.insert(it, std::move(location));
+        kind = ConfigChangeKind::Added;
+        return true;
+    }
+    const bool modified = it->hash != location.hash;
+    *it = std::move(location);
+    kind = ConfigChangeKind::Modified;
+    return modified;
+}
+
+bool ConfigLocationIndex::load(const std::string& indexPath)
+{
+    locations_.clear();
+    stations_.clear();
+    pending_.clear();
+    directory_.clear();
+    const std::string filePath = resolveConfigPath(indexPath);
+    std::ifstream in(filePath);
+    std::string line;
+    if (!in || !std::getline(in, line) || line.compare(0, std::strlen(indexMagic), indexMagic) != 0)
+    {
+        getConfigErrorLog().report(in ? ConfigStatus::InvalidFormat : ConfigStatus::IOError, filePath, in ? "not a configuration index" : "");
+        return false;
+    }
+    directory_ = line.substr(std::min(line.size(), std::strlen(indexMagic) + 1));
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        char kind = 0;
+        fields >> kind;
+        if (kind == 'S')
+        {
+            int station;
+            timespec mtime;
+            if (fields >> station >> mtime.tv_sec >> mtime.tv_nsec)
+            {
+                stations_[station] = mtime;
+                continue;
+            }
+        }
+        else if (kind == 'R')
+        {
+            ConfigLocation location;
+            if (fields >> location.station >> location.run >> location.size >> location.mtime.tv_sec >> location.mtime.tv_nsec >> std::hex >> location.hash >> std::ws &&
+                std::getline(fields, location.path) && !location.path.empty())
+            {
+                locations_.push_back(std::move(location));
+                continue;
+            }
+        }
+        else if (kind == 'P')
+        {
+            int station;
+            int run;
+            if (fields >> station >> run)
+            {
+                pending_.insert({station, run});
+                continue;
+            }
+        }
+        getConfigErrorLog().report(ConfigStatus::InvalidFormat, filePath, "cannot parse line " + line);
+        locations_.clear();
+        stations_.clear();
+        pending_.clear();
+        directory_.clear();
+        return false;
+    }
+    std::sort(locations_.begin(), locations_.end(), [](const ConfigLocation& a, const ConfigLocation& b)
+    {
+        return std::make_pair(a.station, a.run) < std::make_pair(b.station, b.run);
+    });
+    return true;
+}
+
+bool ConfigLocationIndex::save(const std::string& indexPath) const
+{
+    const std::string filePath = resolveConfigPath(indexPath);
+    const std::string temporaryPath = filePath + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::trunc);
+    out << indexMagic << " " << directory_ << "\n";
+    for (const auto& station : stations_)
+    {
+        out << "S " << station.first << " " << station.second.tv_sec << " " << station.second.tv_nsec << "\n";
+    }
+    for (const ConfigLocation& location : locations_)
+    {
+        out << "R " << location.station << " " << location.run << " " << location.size << " " << location.mtime.tv_sec << " "
+            << location.mtime.tv_nsec << " " << std::hex << location.hash << std::dec << " " << location.path << "\n";
+    }
+    for (const std::pair<int, int>& run : pending_)
+    {
+        out << "P " << run.first << " " << run.second << "\n";
+    }
+    out.close();
+    if (!out || std::rename(temporaryPath.c_str(), filePath.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        getConfigErrorLog().report(ConfigStatus::IOError, filePath, "cannot write index");
+        return false;
+    }
+    return true;
+}
+
+ConfigWatcher::~ConfigWatcher()
+{
+    closeEvents();
+}
+
+int ConfigWatcher::start(const Callback& callback)
+{
+    closeEvents();
+    if (!forcePolling_)
+    {
+        openEvents();
+    }
+    nextPoll_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(pollInterval_);
+    return pollIndex(callback, true);
+}
+
+int ConfigWatcher::poll(int timeout, const Callback& callback)
+{
+#ifdef __linux__
+    if (inotifyFd_ >= 0)
+    {
+        pollfd fd = {inotifyFd_, POLLIN, 0};
+        if (::poll(&fd, 1, changed_.empty() ? timeout : 0) > 0 && !readEvents())
+        {
+            // Events were lost, watch the tree again and catch up with a full update of the index
+            closeEvents();
+            openEvents();
+            return pollIndex(callback, true);
+        }
+        return applyChanges(callback);
+    }
+#endif
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < nextPoll_)
+    {
+        std::this_thread::sleep_for(std::min(std::chrono::ceil<std::chrono::milliseconds>(nextPoll_ - now), std::chrono::milliseconds(timeout)));
+        if (std::chrono::steady_clock::now() < nextPoll_)
+        {
+            return 0;
+        }
+    }
+    nextPoll_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(pollInterval_);
+    return pollIndex(callback, false);
+}
+
+bool ConfigWatcher::addWatch(const std::string& path, const Watch& watch)
+{
+#ifdef __linux__
+    const uint32_t mask = watch.cfg ? IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM : IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_ONLYDIR;
+    const int wd = inotify_add_watch(inotifyFd_, path.c_str(), mask);
+    if (wd < 0)
+    {
+        // A directory removed before it could be watched is reported by the watch of its parent
+        return errno == ENOENT || errno == ENOTDIR;
+    }
+    watches_[wd] = watch;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ConfigWatcher::watchStation(int station)
+{
+    const std::string stationPath = directory_ + "/station" + std::to_string(station);
+    if (!addWatch(stationPath, {station, -1, false}))
+    {
+        return false;
+    }
+    for (const auto& runDir : listNumberedDirectories(stationPath, "run"))
+    {
+        if (!watchRun(station, runDir.first))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ConfigWatcher::watchRun(int station, int run)
+{
+    changed_.insert({station, run});
+    const std::string cfgPath = directory_ + "/station" + std::to_string(station) + "/run" + std::to_string(run) + "/cfg";
+    struct stat cfgStat;
+    if (stat(cfgPath.c_str(), &cfgStat) == 0 && S_ISDIR(cfgStat.st_mode))
+    {
+        return addWatch(cfgPath, {station, run, true});
+    }
+    return addWatch(cfgPath.substr(0, cfgPath.size() - 4), {station, run, false});
+}
+
+bool ConfigWatcher::openEvents()
+{
+#ifdef __linux__
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    bool watching = inotifyFd_ >= 0 && addWatch(directory_, {-1, -1, false});
+    for (const auto& stationDir : listNumberedDirectories(directory_, "station"))
+    {
+        watching = watching && watchStation(stationDir.first);
+    }
+    // The runs found while watching are indexed by the full update that follows
+    changed_.clear();
+    if (watching)
+    {
+        return true;
+    }
+    getConfigErrorLog().report(ConfigStatus::IOError, directory_, std::string("cannot watch for changes, polling instead: ") + std::strerror(errno));
+    closeEvents();
+#endif
+    return false;
+}
+
+bool ConfigWatcher::readEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[16384];
+    for (;;)
+    {
+        const ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            return length == 0 || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                return false;
+            }
+            auto it = watches_.find(event->wd);
+            if (it == watches_.end())
+            {
+                continue;
+            }
+            const Watch watch = it->second;
+            if (event->mask & IN_IGNORED)
+            {
+                // The watched directory was removed. A run whose cfg directory went away is watched again until it gets a new one.
+                watches_.erase(it);
+                if (watch.cfg && !watchRun(watch.station, watch.run))
+                {
+                    return false;
+                }
+                continue;
+            }
+            const std::string name = event->len ? event->name : "";
+            const bool created = event->mask & (IN_CREATE | IN_MOVED_TO);
+            int number;
+            if (watch.station < 0)
+            {
+                if (!parseNumberedName(name, "station", number))
+                {
+                    continue;
+                }
+                if (created && !watchStation(number))
+                {
+                    return false;
+                }
+                for (const ConfigLocation& location : index_.getLocations())
+                {
+                    if (location.station == number)
+                    {
+                        changed_.insert({location.station, location.run});
+                    }
+                }
+            }
+            else if (watch.run < 0)
+            {
+                if (!parseNumberedName(name, "run", number))
+                {
+                    continue;
+                }
+                changed_.insert({watch.station, number});
+                if (created && !watchRun(watch.station, number))
+                {
+                    return false;
+                }
+            }
+            else if (!watch.cfg)
+            {
+                if (name == "cfg" && created)
+                {
+                    inotify_rm_watch(inotifyFd_, it->first);
+                    watches_.erase(it);
+                    if (!watchRun(watch.station, watch.run))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else if (name == "acq.cfg")
+            {
+                changed_.insert({watch.station, watch.run});
+            }
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+int ConfigWatcher::applyChanges(const Callback& callback)
+{
+    std::set<std::pair<int, int>> changed;
+    changed.swap(changed_);
+    int reported = 0;
+    for (const std::pair<int, int>& run : changed)
+    {
+        ConfigChangeKind kind;
+        if (index_.updateRun(run.first, run.second, kind))
+        {
+            if (callback)
+            {
+                callback(makeUpdate(run.first, run.second, kind));
+            }
+            ++reported;
+        }
+    }
+    return reported;
+}
+
+int ConfigWatcher::pollIndex(const Callback& callback, bool verifyFiles)
+{
+    std::vector<ConfigLocation> previous;
+    if (index_.getDirectory() == directory_)
+    {
+        previous = index_.getLocations();
+    }
+    index_.update(directory_, verifyFiles);
+    const std::vector<ConfigLocation>& current = index_.getLocations();
+
+    // Both lists are sorted by station and run
+    int reported = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < previous.size() || j < current.size())
+    {
+        const bool removed = j == current.size() || (i < previous.size() && std::make_pair(previous[i].station, previous[i].run) < std::make_pair(current[j].station, current[j].run));
+        const bool added = !removed && (i == previous.size() || std::make_pair(current[j].station, current[j].run) < std::make_pair(previous[i].station, previous[i].run));
+        const ConfigLocation& location = removed ? previous[i] : current[j];
+        ConfigChangeKind kind = removed ? ConfigChangeKind::Removed : added ? ConfigChangeKind::Added : ConfigChangeKind::Modified;
+        const bool changed = removed || added || previous[i].hash != current[j].hash;
+        i += added ? 0 : 1;
+        j += removed ? 0 : 1;
+        if (!changed)
+        {
+            continue;
+        }
+        if (callback)
+        {
+            callback(makeUpdate(location.station, location.run, kind));
+        }
+        ++reported;
+    }
+    return reported;
+}
+
+ConfigUpdate ConfigWatcher::makeUpdate(int station, int run, ConfigChangeKind kind)
+{
+    ConfigUpdate update;
+    update.station = station;
+    update.run = run;
+    update.kind = kind;
+    if (const ConfigLocation* location = index_.find(station, run))
+    {
+        update.location = *location;
+    }
+    else
+    {
+        update.location.station = station;
+        update.location.run = run;
+        update.location.path = getConfigFilepath(station, run, directory_);
+    }
+    if (kind == ConfigChangeKind::Removed)
+    {
+        getConfigCache().invalidate(update.location.path);
+    }
+    else
+    {
+        update.config = getConfigCache().get(update.location.path);
+    }
+    return update;
+}
+
+void ConfigWatcher::closeEvents()
+{
+    if (inotifyFd_ >= 0)
+    {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+    watches_.clear();
+    changed_.clear();
+}
+
+void packFlatConfigs(std::vector<SnapshotRun>& runs)
+{
+    InternedFlatTables tables = internFlatConfigs(runs);
+    auto align = [](size_t offset) { return (offset + 7) & ~size_t(7); };
+
+    std::vector<size_t> offsets(runs.size());
+    size_t size = 0;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        offsets[i] = size;
+        size += tables.settings[i].size() * sizeof(FlatSetting);
+        size = align(size + tables.settings[i].size() * sizeof(uint32_t));
+        size += tables.elements[i].size() * sizeof(FlatValue);
+    }
+    const size_t stringsOffset = size;
+    size += tables.strings.size();
+
+    std::shared_ptr<char> block(new char[std::max<size_t>(size, 1)], std::default_delete<char[]>());
+    char* data = block.get();
+    const char* strings = data + stringsOffset;
+    std::memcpy(data + stringsOffset, tables.strings.data(), tables.strings.size());
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const std::vector<FlatSetting>& settings = tables.settings[i];
+        const std::vector<FlatValue>& elements = tables.elements[i];
+        char* settingsData = data + offsets[i];
+        char* sortedData = settingsData + settings.size() * sizeof(FlatSetting);
+        char* elementsData = data + align(offsets[i] + settings.size() * (sizeof(FlatSetting) + sizeof(uint32_t)));
+        std::memcpy(settingsData, settings.data(), settings.size() * sizeof(FlatSetting));
+        std::memcpy(sortedData, runs[i].config.getSortedData(), settings.size() * sizeof(uint32_t));
+        std::memcpy(elementsData, elements.data(), elements.size() * sizeof(FlatValue));
+        runs[i].config = FlatConfig(block, reinterpret_cast<const FlatSetting*>(settingsData), static_cast<uint32_t>(settings.size()),
+                                    reinterpret_cast<const uint32_t*>(sortedData), reinterpret_cast<const FlatValue*>(elementsData),
+                                    static_cast<uint32_t>(elements.size()), strings, static_cast<uint32_t>(tables.strings.size()));
+    }
+}
+
+std::vector<SnapshotRun> loadFlatConfigs(const std::string& directory, const std::vector<ConfigRun>& runs, unsigned int nThreads)
+{
+    std::vector<SnapshotRun> loaded(runs.size());
+    std::vector<char> valid(runs.size(), 0);
+    parallelFor(runs.size(), nThreads, [&](size_t i)
+    {
+        std::shared_ptr<const libconfig::Config> cfg = getConfigCache().get(getConfigFilepath(runs[i].station, runs[i].run, directory));
+        if (cfg)
+        {
+            loaded[i].station = runs[i].station;
+            loaded[i].run = runs[i].run;
+            loaded[i].config = flattenConfig(*cfg);
+            valid[i] = 1;
+        }
+    });
+
+    std::vector<SnapshotRun> validRuns;
+    validRuns.reserve(runs.size());
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        if (valid[i])
+        {
+            validRuns.push_back(std::move(loaded[i]));
+        }
+    }
+    packFlatConfigs(validRuns);
+    return validRuns;
+}
+
+FlatType mergeBranchTypes(FlatType a, FlatType b)
+{
+    if (a == FlatType::None || a == b)
+    {
+        return b;
+    }
+    const bool aNumber = a == FlatType::Int || a == FlatType::Int64 || a == FlatType::Float;
+    const bool bNumber = b == FlatType::Int || b == FlatType::Int64 || b == FlatType::Float;
+    if (aNumber && bNumber)
+    {
+        return a == FlatType::Float || b == FlatType::Float ? FlatType::Float : FlatType::Int64;
+    }
+    return a;
+}
+
+std::vector<ConfigBranchSpec> inferConfigBranches(const std::vector<SnapshotRun>& runs, const std::vector<std::string>& paths)
+{
+    std::vector<std::string> filters;
+    filters.reserve(paths.size());
+    for (const std::string& path : paths)
+    {
+        std::string_view resolved = path.find('.') == std::string::npos ? resolveCommonSettingAlias(path) : std::string_view();
+        filters.emplace_back(resolved.empty() ? std::string_view(path) : resolved);
+    }
+
+    std::map<std::string, ConfigBranchSpec, std::less<>> specs;
+    std::map<std::string, bool, std::less<>> unsupported;
+    for (const SnapshotRun& run : runs)
+    {
+        const FlatConfig& flat = run.config;
+        for (size_t i = 0; i < flat.size(); ++i)
+        {
+            const FlatSetting& setting = flat[i];
+            const FlatType type = setting.value.type;
+            std::string_view path = flat.getPath(setting);
+            if (type == FlatType::Group || type == FlatType::None || !pathMatches(path, filters))
+            {
+                continue;
+            }
+            auto it = specs.find(path);
+            if (it == specs.end())
+            {
+                ConfigBranchSpec spec;
+                spec.path.assign(path.data(), path.size());
+                it = specs.emplace(spec.path, std::move(spec)).first;
+            }
+            ConfigBranchSpec& spec = it->second;
+            if (type != FlatType::Array && type != FlatType::List)
+            {
+                spec.type = mergeBranchTypes(spec.type, type);
+                continue;
+            }
+            spec.type = mergeBranchTypes(spec.type, FlatType::Array);
+            const FlatValue* elements = flat.getElements(setting.value);
+            for (uint32_t e = 0; e < setting.value.elements.length; ++e)
+            {
+                const FlatType elementType = elements[e].type;
+                if (elementType == FlatType::Group || elementType == FlatType::Array || elementType == FlatType::List)
+                {
+                    unsupported[spec.path] = true;
+                    break;
+                }
+                spec.elementType = mergeBranchTypes(spec.elementType, elementType);
+            }
+        }
+    }
+
+    // Paths such as a.b_c and a_b.c give the same name, the later paths get a numbered suffix. station and run are taken by the tree.
+    std::set<std::string> names = {"station", "run"};
+    std::vector<ConfigBranchSpec> branches;
+    branches.reserve(specs.size());
+    for (auto& entry : specs)
+    {
+        ConfigBranchSpec& spec = entry.second;
+        if (spec.type == FlatType::Array && (unsupported.count(spec.path) || spec.elementType == FlatType::None))
+        {
+            continue;
+        }
+        std::string name = spec.path;
+        std::replace(name.begin(), name.end(), '.', '_');
+        spec.name = name;
+        for (int suffix = 2; !names.insert(spec.name).second; ++suffix)
+        {
+            spec.name = name + "_" + std::to_string(suffix);
+        }
+        branches.push_back(std::move(spec));
+    }
+    return branches;
+}
+
+#ifdef RNOG_CONFIG_HAVE_ROOT
+
+bool exportConfigTree(const std::string& outputPath, const std::vector<SnapshotRun>& runs, const std::vector<std::string>& paths, const std::string& treeName)
+{
+    const std::vector<ConfigBranchSpec> specs = inferConfigBranches(runs, paths);
+    const std::string filePath = resolveConfigPath(outputPath);
+    std::unique_ptr<TFile> file(TFile::Open(filePath.c_str(), "RECREATE"));
+    if (!file || file->IsZombie())
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, filePath, "cannot create ROOT file");
+        return false;
+    }
+
+    TTree* tree = new TTree(treeName.c_str(), "RNO-G run configurations");
+    Int_t station = 0;
+    Int_t run = 0;
+    tree->Branch("station", &station, "station/I");
+    tree->Branch("run", &run, "run/I");
+    std::vector<ConfigBranchBuffer> buffers(specs.size());
+    for (size_t i = 0; i < specs.size(); ++i)
+    {
+        const ConfigBranchSpec& spec = specs[i];
+        ConfigBranchBuffer& buffer = buffers[i];
+        const char* name = spec.name.c_str();
+        TBranch* branch = nullptr;
+        switch (spec.type == FlatType::Array ? spec.elementType : spec.type)
+        {
+        case FlatType::Int:
+            branch = spec.type == FlatType::Array ? tree->Branch(name, &buffer.intValues) : tree->Branch(name, &buffer.intValue, (spec.name + "/I").c_str());
+            break;
+        case FlatType::Int64:
+            branch = spec.type == FlatType::Array ? tree->Branch(name, &buffer.int64Values) : tree->Branch(name, &buffer.int64Value, (spec.name + "/L").c_str());
+            break;
+        case FlatType::Float:
+            branch = spec.type == FlatType::Array ? tree->Branch(name, &buffer.floatValues) : tree->Branch(name, &buffer.floatValue, (spec.name + "/D").c_str());
+            break;
+        case FlatType::Boolean:
+            branch = spec.type == FlatType::Array ? tree->Branch(name, &buffer.boolValues) : tree->Branch(name, &buffer.boolValue, (spec.name + "/O").c_str());
+            break;
+        default:
+            branch = spec.type == FlatType::Array ? tree->Branch(name, &buffer.stringValues) : tree->Branch(name, &buffer.stringValue);
+            break;
+        }
+        branch->SetTitle(spec.path.c_str());
+    }
+
+    for (const SnapshotRun& snapshotRun : runs)
+    {
+        const FlatConfig& flat = snapshotRun.config;
+        station = snapshotRun.station;
+        run = snapshotRun.run;
+        for (size_t i = 0; i < specs.size(); ++i)
+        {
+            const ConfigBranchSpec& spec = specs[i];
+            ConfigBranchBuffer& buffer = buffers[i];
+            const FlatSetting* setting = flat.find(spec.path);
+            if (spec.type == FlatType::Array)
+            {
+                switch (spec.elementType)
+                {
+                case FlatType::Int: fillBranchVector(buffer.intValues, flat, setting); break;
+                case FlatType::Int64: fillBranchVector(buffer.int64Values, flat, setting); break;
+                case FlatType::Float: fillBranchVector(buffer.floatValues, flat, setting); break;
+                case FlatType::Boolean: fillBranchVector(buffer.boolValues, flat, setting); break;
+                default: fillBranchVector(buffer.stringValues, flat, setting); break;
+                }
+                continue;
+            }
+            const FlatValue* value = setting ? &setting->value : nullptr;
+            switch (spec.type)
+            {
+            case FlatType::Int:
+                buffer.intValue = value ? convertFlatValue<Int_t>(flat, *value).value_or(0) : 0;
+                break;
+            case FlatType::Int64:
+                buffer.int64Value = value ? convertFlatValue<Long64_t>(flat, *value).value_or(0) : 0;
+                break;
+            case FlatType::Float:
+                buffer.floatValue = value ? convertFlatValue<Double_t>(flat, *value).value_or(std::numeric_limits<Double_t>::quiet_NaN()) : std::numeric_limits<Double_t>::quiet_NaN();
+                break;
+            case FlatType::Boolean:
+                buffer.boolValue = value ? convertFlatValue<bool>(flat, *value).value_or(false) : false;
+                break;
+            default:
+                buffer.stringValue = value ? convertFlatValue<std::string>(flat, *value).value_or(std::string()) : std::string();
+                break;
+            }
+        }
+        tree->Fill();
+    }
+
+    const bool written = tree->Write() > 0 || runs.empty();
+    file->Close();
+    if (!written)
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, filePath, "cannot write TTree");
+    }
+    return written;
+}
+
+bool exportConfigTree(const std::string& outputPath, const std::string& directory, const std::vector<ConfigRun>& runs, const std::vector<std::string>& paths, const std::string& treeName, unsigned int nThreads)
+{
+    return exportConfigTree(outputPath, loadFlatConfigs(directory, runs, nThreads), paths, treeName);
+}
+
+#endif
+
+bool parseConfigQuery(const std::string& query, std::vector<ConfigPredicate>& predicates)
+{
+    predicates.clear();
+    auto trim = [](std::string_view text)
+    {
+        const size_t begin = text.find_first_not_of(" \t\n");
+        if (begin == std::string_view::npos)
+        {
+            return std::string_view();
+        }
+        return text.substr(begin, text.find_last_not_of(" \t\n") - begin + 1);
+    };
+    static const std::array<std::pair<std::string_view, ConfigCompare>, 6> operators = {{
+        {"==", ConfigCompare::Equal}, {"!=", ConfigCompare::NotEqual}, {"<=", ConfigCompare::LessEqual},
+        {">=", ConfigCompare::GreaterEqual}, {"<", ConfigCompare::Less}, {">", ConfigCompare::Greater}}};
+
+    std::string_view rest(query);
+    while (!rest.empty())
+    {
+        const size_t end = rest.find("&&");
+        const std::string_view condition = trim(rest.substr(0, end));
+        rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 2);
+
+        ConfigPredicate predicate;
+        const size_t operatorPosition = condition.find_first_of("=!<>");
+        std::string_view path = trim(condition.substr(0, operatorPosition));
+        if (operatorPosition != std::string_view::npos)
+        {
+            std::string_view value;
+            for (const auto& op : operators)
+            {
+                if (condition.compare(operatorPosition, op.first.size(), op.first) == 0)
+                {
+                    predicate.compare = op.second;
+                    value = trim(condition.substr(operatorPosition + op.first.size()));
+                    break;
+                }
+            }
+            if (predicate.compare == ConfigCompare::Exists || value.empty())
+            {
+                getConfigErrorLog().report(ConfigStatus::InvalidFormat, query, "cannot parse condition " + std::string(condition));
+                return false;
+            }
+            if (value == "true" || value == "false")
+            {
+                predicate.isNumber = true;
+                predicate.number = value == "true" ? 1 : 0;
+            }
+            else if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            {
+                predicate.text.assign(value.data() + 1, value.size() - 2);
+            }
+            else
+            {
+                const std::string number(value);
+                char* numberEnd = nullptr;
+                predicate.number = std::strtod(number.c_str(), &numberEnd);
+                predicate.isNumber = numberEnd == number.c_str() + number.size();
+                predicate.text = number;
+            }
+        }
+        if (path.empty())
+        {
+            getConfigErrorLog().report(ConfigStatus::InvalidFormat, query, "missing setting path in condition " + std::string(condition));
+            return false;
+        }
+        std::string_view resolved = path.find('.') == std::string_view::npos && path != "station" && path != "run" ? resolveCommonSettingAlias(path) : std::string_view();
+        predicate.path.assign(resolved.empty() ? path : resolved);
+        predicates.push_back(std::move(predicate));
+    }
+    return true;
+}
+
+std::vector<ConfigRun> ConfigQueryIndex::select(const std::vector<ConfigPredicate>& predicates) const
+{
+    std::vector<uint64_t> selected((runs_.size() + 63) / 64, ~uint64_t(0));
+    for (const ConfigPredicate& predicate : predicates)
+    {
+        std::vector<uint64_t> matching = match(predicate);
+        for (size_t i = 0; i < selected.size(); ++i)
+        {
+            selected[i] &= matching[i];
+        }
+    }
+
+    std::vector<ConfigRun> result;
+    for (size_t i = 0; i < runs_.size(); ++i)
+    {
+        if (selected[i / 64] >> (i % 64) & 1)
+        {
+            result.push_back({runs_[i].station, runs_[i].run});
+        }
+    }
+    return result;
+}
+
+const ConfigQueryIndex::PathIndex& ConfigQueryIndex::getPathIndex(const std::string& path) const
+{
+    SettingPathId id = getSettingPathPool().find(path);
+    if (id != invalidSettingPathId)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = indexes_.find(id);
+        if (it != indexes_.end())
+        {
+            return it->second;
+        }
+    }
+
+    PathIndex index;
+    for (uint32_t i = 0; i < runs_.size(); ++i)
+    {
+        if (path == "station" || path == "run")
+        {
+            index.numbers.emplace_back(path == "station" ? runs_[i].station : runs_[i].run, i);
+            continue;
+        }
+        const FlatConfig& flat = runs_[i].config;
+        const FlatSetting* setting = flat.find(path);
+        if (!setting)
+        {
+            continue;
+        }
+        const FlatValue& value = setting->value;
+        if (value.type == FlatType::Int || value.type == FlatType::Int64)
+        {
+            index.numbers.emplace_back(static_cast<double>(value.intValue), i);
+        }
+        else if (value.type == FlatType::Float)
+        {
+            index.numbers.emplace_back(value.floatValue, i);
+        }
+        else if (value.type == FlatType::Boolean)
+        {
+            index.numbers.emplace_back(value.boolValue ? 1 : 0, i);
+        }
+        else if (value.type == FlatType::String)
+        {
+            index.strings.emplace_back(flat.getString(value), i);
+        }
+    }
+    // Paths no run has are a miss and are neither interned nor cached, so queries from clients cannot grow the pool or the index
+    static const PathIndex emptyIndex;
+    if (index.numbers.empty() && index.strings.empty())
+    {
+        return emptyIndex;
+    }
+    std::sort(index.numbers.begin(), index.numbers.end());
+    std::sort(index.strings.begin(), index.strings.end());
+    id = getSettingPathPool().intern(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return indexes_.emplace(id, std::move(index)).first->second;
+}
+
+std::vector<uint64_t> ConfigQueryIndex::match(const ConfigPredicate& predicate) const
+{
+    const PathIndex& index = getPathIndex(predicate.path);
+    std::vector<uint64_t> bits((runs_.size() + 63) / 64, 0);
+    if (predicate.compare == ConfigCompare::Exists || predicate.isNumber)
+    {
+        matchValues(bits, index.numbers, predicate.compare, predicate.number);
+    }
+    if (predicate.compare == ConfigCompare::Exists || !predicate.isNumber)
+    {
+        matchValues(bits, index.strings, predicate.compare, std::string_view(predicate.text));
+    }
+    return bits;
+}
+
+bool ConfigSchema::parse(std::string_view text, const std::string& source)
+{
+    static const std::array<std::pair<std::string_view, ConfigSchemaType>, 9> types = {{
+        {"any", ConfigSchemaType::Any}, {"int", ConfigSchemaType::Int}, {"float", ConfigSchemaType::Float},
+        {"number", ConfigSchemaType::Number}, {"bool", ConfigSchemaType::Boolean}, {"string", ConfigSchemaType::String},
+        {"group", ConfigSchemaType::Group}, {"array", ConfigSchemaType::Array}, {"list", ConfigSchemaType::List}}};
+    auto parseType = [](const std::string& name, ConfigSchemaType& type)
+    {
+        for (const auto& entry : types)
+        {
+            if (entry.first == name)
+            {
+                type = entry.second;
+                return true;
+            }
+        }
+        return false;
+    };
+    auto parseNumber = [](const std::string& value, double& number)
+    {
+        char* end = nullptr;
+        number = std::strtod(value.c_str(), &end);
+        return !value.empty() && end == value.c_str() + value.size();
+    };
+
+    std::vector<ConfigSchemaRule> rules;
+    std::istringstream lines{std::string(text)};
+    std::string line;
+    for (int lineNumber = 1; std::getline(lines, line); ++lineNumber)
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        ConfigSchemaRule rule;
+        std::string typeName;
+        if (!(words >> rule.path))
+        {
+            continue;
+        }
+        bool valid = static_cast<bool>(words >> typeName) && parseType(typeName, rule.type);
+        std::string field;
+        while (valid && words >> field)
+        {
+            const size_t equals = field.find('=');
+            const std::string key = field.substr(0, equals);
+            const std::string value = equals == std::string::npos ? std::string() : field.substr(equals + 1);
+            double number = 0;
+            if (equals == std::string::npos && (key == "required" || key == "optional"))
+            {
+                rule.required = key == "required";
+            }
+            else if (key == "element")
+            {
+                valid = parseType(value, rule.elementType);
+            }
+            else if (key == "min" || key == "max")
+            {
+                valid = parseNumber(value, key == "min" ? rule.minimum : rule.maximum);
+            }
+            else if ((key == "length" || key == "minlength" || key == "maxlength") && parseNumber(value, number) && number >= 0 &&
+                     number <= std::numeric_limits<uint32_t>::max() && number == static_cast<uint32_t>(number))
+            {
+                if (key != "maxlength")
+                {
+                    rule.minLength = static_cast<uint32_t>(number);
+                }
+                if (key != "minlength")
+                {
+                    rule.maxLength = static_cast<uint32_t>(number);
+                }
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+        if (!valid)
+        {
+            getConfigErrorLog().report(ConfigStatus::InvalidFormat, source, "cannot parse schema line " + std::to_string(lineNumber) + ": " + line);
+            return false;
+        }
+        rules.push_back(std::move(rule));
+    }
+    compile(std::move(rules));
+    return true;
+}
+
+uint32_t ConfigSchema::typeMask(ConfigSchemaType type)
+{
+    auto bit = [](FlatType flatType) { return uint32_t(1) << static_cast<int>(flatType); };
+    switch (type)
+    {
+    case ConfigSchemaType::Int: return bit(FlatType::Int) | bit(FlatType::Int64);
+    case ConfigSchemaType::Float: return bit(FlatType::Float);
+    case ConfigSchemaType::Number: return bit(FlatType::Int) | bit(FlatType::Int64) | bit(FlatType::Float);
+    case ConfigSchemaType::Boolean: return bit(FlatType::Boolean);
+    case ConfigSchemaType::String: return bit(FlatType::String);
+    case ConfigSchemaType::Group: return bit(FlatType::Group);
+    case ConfigSchemaType::Array: return bit(FlatType::Array);
+    case ConfigSchemaType::List: return bit(FlatType::List);
+    default: return ~uint32_t(0);
+    }
+}
+
+void ConfigSchema::compile(std::vector<ConfigSchemaRule> rules)
+{
+    std::stable_sort(rules.begin(), rules.end(), [](const ConfigSchemaRule& a, const ConfigSchemaRule& b)
+    {
+        return a.path < b.path;
+    });
+    rules_.clear();
+    compiled_.clear();
+    for (size_t i = 0; i < rules.size(); ++i)
+    {
+        // Keep the last of the rules for a path
+        if (i + 1 < rules.size() && rules[i + 1].path == rules[i].path)
+        {
+            continue;
+        }
+        const ConfigSchemaRule& rule = rules[i];
+        compiled_.push_back({typeMask(rule.type), typeMask(rule.elementType),
+                             rule.minimum > -std::numeric_limits<double>::infinity() || rule.maximum < std::numeric_limits<double>::infinity(),
+                             rule.minLength > 0 || rule.maxLength < std::numeric_limits<uint32_t>::max()});
+        rules_.push_back(std::move(rules[i]));
+    }
+}
+
+size_t ConfigSchema::validate(const FlatConfig& flat, std::vector<ConfigViolation>& violations, int station, int run) const
+{
+    const size_t count = violations.size();
+    size_t position = 0;
+    for (uint32_t r = 0; r < rules_.size(); ++r)
+    {
+        const ConfigSchemaRule& rule = rules_[r];
+        const CompiledRule& compiled = compiled_[r];
+        auto report = [&](ConfigViolationKind kind, int element, double value)
+        {
+            violations.push_back({station, run, r, kind, element, value});
+        };
+
+        // The rules and the index of the configuration are both sorted by path
+        while (position < flat.size() && flat.getPath(flat.getSorted(position)) < rule.path)
+        {
+            ++position;
+        }
+        if (position == flat.size() || flat.getPath(flat.getSorted(position)) != rule.path)
+        {
+            if (rule.required)
+            {
+                report(ConfigViolationKind::Missing, -1, 0);
+            }
+            continue;
+        }
+        const FlatValue& value = flat.getSorted(position).value;
+        double number = 0;
+        if (!(compiled.typeMask >> static_cast<int>(value.type) & 1))
+        {
+            report(ConfigViolationKind::WrongType, -1, 0);
+        }
+        else if (value.type == FlatType::Array || value.type == FlatType::List)
+        {
+            const uint32_t length = value.elements.length;
+            if (compiled.checkLength && (length < rule.minLength || length > rule.maxLength))
+            {
+                report(ConfigViolationKind::WrongLength, -1, length);
+            }
+            const FlatValue* elements = flat.getElements(value);
+            for (uint32_t e = 0; e < length; ++e)
+            {
+                if (!(compiled.elementMask >> static_cast<int>(elements[e].type) & 1))
+                {
+                    report(ConfigViolationKind::WrongType, static_cast<int>(e), 0);
+                }
+                else if (!inRange(compiled, rule, elements[e], number))
+                {
+                    report(ConfigViolationKind::OutOfRange, static_cast<int>(e), number);
+                }
+            }
+        }
+        else if (value.type == FlatType::String)
+        {
+            const size_t length = value.text.length;
+            if (compiled.checkLength && (length < rule.minLength || length > rule.maxLength))
+            {
+                report(ConfigViolationKind::WrongLength, -1, static_cast<double>(length));
+            }
+        }
+        else if (!inRange(compiled, rule, value, number))
+        {
+            report(ConfigViolationKind::OutOfRange, -1, number);
+        }
+    }
+    return violations.size() - count;
+}
+
+std::vector<ConfigViolation> validateConfigs(const ConfigSchema& schema, const std::vector<SnapshotRun>& runs, unsigned int nThreads)
+{
+    std::vector<std::vector<ConfigViolation>> perRun(runs.size());
+    parallelFor(runs.size(), nThreads, [&](size_t i)
+    {
+        schema.validate(runs[i].config, perRun[i], runs[i].station, runs[i].run);
+    });
+    std::vector<ConfigViolation> violations;
+    for (const std::vector<ConfigViolation>& runViolations : perRun)
+    {
+        violations.insert(violations.end(), runViolations.begin(), runViolations.end());
+    }
+    return violations;
+}
+
+std::vector<ConfigViolation> validateConfigs(const ConfigSchema& schema, const std::string& directory, unsigned int nThreads)
+{
+    const std::vector<ConfigRun> runs = findConfigRuns(directory);
+    std::vector<std::vector<ConfigViolation>> perRun(runs.size());
+    parallelFor(runs.size(), nThreads, [&](size_t i)
+    {
+        std::shared_ptr<const libconfig::Config> cfg = getConfigCache().get(getConfigFilepath(runs[i].station, runs[i].run, directory));
+        if (cfg)
+        {
+            schema.validate(flattenConfig(*cfg), perRun[i], runs[i].station, runs[i].run);
+        }
+    });
+    std::vector<ConfigViolation> violations;
+    for (const std::vector<ConfigViolation>& runViolations : perRun)
+    {
+        violations.insert(violations.end(), runViolations.begin(), runViolations.end());
+    }
+    return violations;
+}
+
+void printConfigViolations(const ConfigSchema& schema, const std::vector<ConfigViolation>& violations, std::ostream& out)
+{
+    const std::vector<ConfigSchemaRule>& rules = schema.getRules();
+    std::vector<size_t> runsPerRule(rules.size(), 0);
+    std::string line;
+    for (size_t i = 0; i < violations.size(); ++i)
+    {
+        const ConfigViolation& violation = violations[i];
+        line.clear();
+        line += "station";
+        appendInteger(line, violation.station);
+        line += " run";
+        appendInteger(line, violation.run);
+        line += " : ";
+        line += rules[violation.rule].path;
+        line += " : ";
+        if (violation.element >= 0)
+        {
+            line += "element ";
+            appendInteger(line, violation.element);
+            line += ' ';
+        }
+        switch (violation.kind)
+        {
+        case ConfigViolationKind::Missing: line += "missing"; break;
+        case ConfigViolationKind::WrongType: line += "wrong type"; break;
+        case ConfigViolationKind::OutOfRange: line += "out of range "; appendFloat(line, static_cast<float>(violation.value), std::chars_format::general); break;
+        case ConfigViolationKind::WrongLength: line += "wrong length "; appendInteger(line, static_cast<long long>(violation.value)); break;
+        }
+        out << line << '\n';
+        // The violations of a run are in rule order, so those of a run and rule are contiguous
+        const ConfigViolation* previous = i > 0 ? &violations[i - 1] : nullptr;
+        if (!previous || previous->station != violation.station || previous->run != violation.run || previous->rule != violation.rule)
+        {
+            ++runsPerRule[violation.rule];
+        }
+    }
+    out << violations.size() << " violations" << std::endl;
+    for (size_t r = 0; r < rules.size(); ++r)
+    {
+        if (runsPerRule[r])
+        {
+            out << rules[r].path << " : " << runsPerRule[r] << " runs" << std::endl;
+        }
+    }
+}
+
+ConfigArchiveCompression detectArchiveCompression(const char* data, size_t size)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b)
+    {
+        return ConfigArchiveCompression::Gzip;
+    }
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd)
+    {
+        return ConfigArchiveCompression::Zstd;
+    }
+    return ConfigArchiveCompression::None;
+}
+
+bool parseConfigMemberName(std::string_view name, int& station, int& run)
+{
+    const std::string_view suffix = "/cfg/acq.cfg";
+    if (name.size() <= suffix.size() || name.substr(name.size() - suffix.size()) != suffix)
+    {
+        return false;
+    }
+    name.remove_suffix(suffix.size());
+    size_t slash = name.rfind('/');
+    if (slash == std::string_view::npos)
+    {
+        return false;
+    }
+    const std::string runName(name.substr(slash + 1));
+    name = name.substr(0, slash);
+    slash = name.rfind('/');
+    const std::string stationName(name.substr(slash == std::string_view::npos ? 0 : slash + 1));
+    return parseNumberedName(stationName, "station", station) && parseNumberedName(runName, "run", run);
+}
+
+bool parseTarHeader(const char* header, std::string& name, uint64_t& size, char& type)
+{
+    auto octal = [header](size_t offset, size_t length)
+    {
+        uint64_t value = 0;
+        size_t i = offset;
+        while (i < offset + length && header[i] == ' ')
+        {
+            ++i;
+        }
+        for (; i < offset + length && header[i] >= '0' && header[i] <= '7'; ++i)
+        {
+            value = value * 8 + (header[i] - '0');
+        }
+        return value;
+    };
+
+    // The checksum sums the header with its own field counted as spaces, old tar versions summed signed chars
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(header);
+    uint64_t unsignedSum = 0;
+    int64_t signedSum = 0;
+    for (size_t i = 0; i < 512; ++i)
+    {
+        const bool checksumField = i >= 148 && i < 156;
+        unsignedSum += checksumField ? ' ' : bytes[i];
+        signedSum += checksumField ? ' ' : static_cast<signed char>(header[i]);
+    }
+    const uint64_t checksum = octal(148, 8);
+    if (checksum != unsignedSum && static_cast<int64_t>(checksum) != signedSum)
+    {
+        return false;
+    }
+
+    // GNU tar stores sizes of 8 GiB and more in base 256, flagged by the high bit
+    if (bytes[124] & 0x80)
+    {
+        size = bytes[124] & 0x7f;
+        for (size_t i = 125; i < 136; ++i)
+        {
+            size = (size << 8) | bytes[i];
+        }
+    }
+    else
+    {
+        size = octal(124, 12);
+    }
+    type = header[156];
+    name.assign(header, strnlen(header, 100));
+    if (std::memcmp(header + 257, "ustar", 6) == 0 && header[345] != '\0')
+    {
+        name = std::string(header + 345, strnlen(header + 345, 155)) + "/" + name;
+    }
+    return true;
+}
+
+/*
+    Reads the tar stream of an archive mapped into memory, decompressing it on the fly.
+*/
+
+class ConfigArchive::Input
+{
+public:
+    Input(const char* data, size_t size, ConfigArchiveCompression compression)
+        : data_(data), size_(size), compression_(compression)
+    {
+#ifdef RNOG_CONFIG_HAVE_ZLIB
+        if (compression_ == ConfigArchiveCompression::Gzip)
+        {
+            // 16 makes zlib expect a gzip header
+            ready_ = inflateInit2(&zlib_, 16 + MAX_WBITS) == Z_OK;
+        }
+#endif
+#ifdef RNOG_CONFIG_HAVE_ZSTD
+        if (compression_ == ConfigArchiveCompression::Zstd)
+        {
+            zstd_ = ZSTD_createDCtx();
+            ready_ = zstd_ != nullptr;
+        }
+#endif
+        if (compression_ == ConfigArchiveCompression::None)
+        {
+            ready_ = true;
+        }
+    }
+
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+
+    ~Input()
+    {
+#ifdef RNOG_CONFIG_HAVE_ZLIB
+        if (compression_ == ConfigArchiveCompression::Gzip && ready_)
+        {
+            inflateEnd(&zlib_);
+        }
+#endif
+#ifdef RNOG_CONFIG_HAVE_ZSTD
+        ZSTD_freeDCtx(zstd_);
+#endif
+    }
+
+    // False if the archive is compressed with a library this build does not have.
+    bool isReady() const
+    {
+        return ready_;
+    }
+
+    // False once the compressed data turned out to be corrupt or truncated.
+    bool isValid() const
+    {
+        return !failed_;
+    }
+
+    // The offset of the next byte in the mapping, which for uncompressed archives is the offset of the next byte of the tar stream.
+    size_t getPosition() const
+    {
+        return position_;
+    }
+
+    // Reads up to size bytes of the tar stream, fewer only at its end or on errors.
+    size_t read(char* buffer, size_t size);
+
+    // Skips size bytes of the tar stream, returning false if it ends first.
+    bool skip(uint64_t size);
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t position_ = 0;
+    ConfigArchiveCompression compression_;
+    bool ready_ = false;
+    bool failed_ = false;
+    bool finished_ = false;
+#ifdef RNOG_CONFIG_HAVE_ZLIB
+    z_stream zlib_ = {};
+#endif
+#ifdef RNOG_CONFIG_HAVE_ZSTD
+    ZSTD_DCtx* zstd_ = nullptr;
+#endif
+};
+
+size_t ConfigArchive::Input::read(char* buffer, size_t size)
+{
+    if (compression_ == ConfigArchiveCompression::None)
+    {
+        const size_t count = std::min(size, size_ - position_);
+        std::memcpy(buffer, data_ + position_, count);
+        position_ += count;
+        return count;
+    }
+    size_t done = 0;
+    while (ready_ && done < size && !finished_ && !failed_)
+    {
+        size_t consumed = 0;
+        size_t produced = 0;
+#ifdef RNOG_CONFIG_HAVE_ZLIB
+        if (compression_ == ConfigArchiveCompression::Gzip)
+        {
+            const uInt available = static_cast<uInt>(std::min<size_t>(size_ - position_, 1u << 30));
+            const uInt space = static_cast<uInt>(std::min<size_t>(size - done, 1u << 30));
+            zlib_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data_ + position_));
+            zlib_.avail_in = available;
+            zlib_.next_out = reinterpret_cast<Bytef*>(buffer + done);
+            zlib_.avail_out = space;
+            const int status = inflate(&zlib_, Z_NO_FLUSH);
+            consumed = available - zlib_.avail_in;
+            produced = space - zlib_.avail_out;
+            position_ += consumed;
+            if (status == Z_STREAM_END)
+            {
+                // Parallel compressors like pigz may write several gzip members one after the other
+                if (position_ == size_ || inflateReset(&zlib_) != Z_OK)
+                {
+                    finished_ = true;
+                }
+            }
+            else if (status != Z_OK && status != Z_BUF_ERROR)
+            {
+                failed_ = true;
+            }
+        }
+#endif
+#ifdef RNOG_CONFIG_HAVE_ZSTD
+        if (compression_ == ConfigArchiveCompression::Zstd)
+        {
+            ZSTD_inBuffer in = {data_ + position_, size_ - position_, 0};
+            ZSTD_outBuffer out = {buffer + done, size - done, 0};
+            const size_t status = ZSTD_decompressStream(zstd_, &out, &in);
+            consumed = in.pos;
+            produced = out.pos;
+            position_ += consumed;
+            if (ZSTD_isError(status))
+            {
+                failed_ = true;
+            }
+            else if (status == 0 && position_ == size_)
+            {
+                finished_ = true;
+            }
+        }
+#endif
+        done += produced;
+        if (consumed == 0 && produced == 0 && !finished_)
+        {
+            // No progress with room to write means the compressed data ended early
+            failed_ = true;
+        }
+    }
+    return done;
+}
+
+bool ConfigArchive::Input::skip(uint64_t size)
+{
+    if (compression_ == ConfigArchiveCompression::None)
+    {
+        if (size > size_ - position_)
+        {
+            position_ = size_;
+            return false;
+        }
+        position_ += size;
+        return true;
+    }
+    char buffer[65536];
+    while (size > 0)
+    {
+        const size_t count = read(buffer, static_cast<size_t>(std::min<uint64_t>(size, sizeof(buffer))));
+        if (count == 0)
+        {
+            return false;
+        }
+        size -= count;
+    }
+    return true;
+}
+
+bool ConfigArchive::open(const std::string& archivePath)
+{
+    path_ = archivePath;
+    mapping_.reset();
+    contents_.clear();
+    members_.clear();
+    std::shared_ptr<const MappedFile> mapping = MappedFile::open(resolveConfigPath(archivePath));
+    if (!mapping)
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, archivePath);
+        return false;
+    }
+    compression_ = detectArchiveCompression(mapping->getData(), mapping->getSize());
+    Input input(mapping->getData(), mapping->getSize(), compression_);
+    if (!input.isReady())
+    {
+        getConfigErrorLog().report(ConfigStatus::InvalidFormat, archivePath, compression_ == ConfigArchiveCompression::Gzip ? "reading gzip archives needs zlib" : "reading zstd archives needs libzstd");
+        return false;
+    }
+    if (!index(input))
+    {
+        contents_.clear();
+        members_.clear();
+        getConfigErrorLog().report(ConfigStatus::InvalidFormat, archivePath, "not a valid tar archive");
+        return false;
+    }
+    if (compression_ == ConfigArchiveCompression::None)
+    {
+        mapping_ = mapping;
+    }
+
+    // Sort the members in archive order by run, keeping the last member of each run
+    std::stable_sort(members_.begin(), members_.end(), [](const Member& a, const Member& b)
+    {
+        return a.station != b.station ? a.station < b.station : a.run < b.run;
+    });
+    size_t kept = 0;
+    for (size_t i = 0; i < members_.size(); ++i)
+    {
+        if (i + 1 < members_.size() && members_[i + 1].station == members_[i].station && members_[i + 1].run == members_[i].run)
+        {
+            continue;
+        }
+        members_[kept++] = members_[i];
+    }
+    members_.resize(kept);
+    return true;
+}
+
+bool ConfigArchive::index(Input& input)
+{
+    char header[512];
+    std::string longName;
+    for (;;)
+    {
+        const size_t count = input.read(header, sizeof(header));
+        if (count == 0)
+        {
+            // Some writers leave out the end of archive blocks
+            return input.isValid();
+        }
+        if (count < sizeof(header))
+        {
+            return false;
+        }
+        if (std::all_of(header, header + sizeof(header), [](char c) { return c == '\0'; }))
+        {
+            return input.isValid();
+        }
+        std::string name;
+        uint64_t size;
+        char type;
+        if (!parseTarHeader(header, name, size, type))
+        {
+            return false;
+        }
+        const uint64_t padding = (512 - size % 512) % 512;
+
+        // GNU long names and pax extended headers name the member that follows them
+        if (type == 'L' || type == 'x')
+        {
+            if (size > (1u << 20))
+            {
+                return false;
+            }
+            std::string data(static_cast<size_t>(size), '\0');
+            if (input.read(&data[0], data.size()) != data.size() || !input.skip(padding))
+            {
+                return false;
+            }
+            if (type == 'L')
+            {
+                longName = data.c_str();
+                continue;
+            }
+            // pax records are "<length> <key>=<value>\n"
+            for (size_t position = 0; position < data.size();)
+            {
+                size_t length = 0;
+                std::from_chars_result result = std::from_chars(data.data() + position, data.data() + data.size(), length);
+                if (result.ec != std::errc() || length == 0 || position + length > data.size())
+                {
+                    break;
+                }
+                std::string_view record(data.data() + position, length);
+                const size_t key = record.find(' ') + 1;
+                if (key != 0 && record.compare(key, 5, "path=") == 0 && record.back() == '\n')
+                {
+                    longName = std::string(record.substr(key + 5, record.size() - key - 6));
+                }
+                position += length;
+            }
+            continue;
+        }
+        if (!longName.empty())
+        {
+            name.swap(longName);
+            longName.clear();
+        }
+
+        int station;
+        int run;
+        if ((type == '0' || type == '\0' || type == '7') && parseConfigMemberName(name, station, run))
+        {
+            Member member{station, run, 0, static_cast<size_t>(size)};
+            if (compression_ == ConfigArchiveCompression::None)
+            {
+                member.offset = input.getPosition();
+                if (!input.skip(size))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                member.offset = contents_.size();
+                contents_.resize(contents_.size() + member.size);
+                if (input.read(&contents_[member.offset], member.size) != member.size)
+                {
+                    return false;
+                }
+            }
+            members_.push_back(member);
+            if (!input.skip(padding))
+            {
+                return false;
+            }
+        }
+        else if (!input.skip(size + padding))
+        {
+            return false;
+        }
+    }
+}
+
+const ConfigArchive::Member* ConfigArchive::find(int station, int run) const
+{
+    auto it = std::lower_bound(members_.begin(), members_.end(), std::make_pair(station, run), [](const Member& member, const std::pair<int, int>& key)
+    {
+        return member.station != key.first ? member.station < key.first : member.run < key.second;
+    });
+    return it != members_.end() && it->station == station && it->run == run ? &*it : nullptr;
+}
+
+std::string_view ConfigArchive::getMember(int station, int run) const
+{
+    const Member* member = find(station, run);
+    if (!member)
+    {
+        return std::string_view();
+    }
+    const char* data = mapping_ ? mapping_->getData() : contents_.data();
+    return std::string_view(data + member->offset, member->size);
+}
+
+bool ConfigArchive::readConfig(int station, int run, libconfig::Config& cfg) const
+{
+    const std::string source = getConfigFilepath(station, run, path_);
+    if (!contains(station, run))
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, source);
+        return false;
+    }
+    std::string_view contents = getMember(station, run);
+    return readConfigFromBuffer(contents.data(), contents.size(), cfg, source);
+}
+
+std::vector<ConfigRun> ConfigArchive::getRuns() const
+{
+    std::vector<ConfigRun> runs;
+    runs.reserve(members_.size());
+    for (const Member& member : members_)
+    {
+        runs.push_back(ConfigRun{member.station, member.run});
+    }
+    return runs;
+}
+
+std::vector<RunConfigValues> scanConfigArchive(const ConfigArchive& archive, const std::vector<std::string>& configSettingPaths, unsigned int nThreads)
+{
+    const std::vector<ConfigRun> runs = archive.getRuns();
+    std::vector<RunConfigValues> results(runs.size());
+    parallelFor(runs.size(), nThreads, [&](size_t i)
+    {
+        RunConfigValues& result = results[i];
+        result.station = runs[i].station;
+        result.run = runs[i].run;
+        libconfig::Config cfg;
+        if (!archive.readConfig(result.station, result.run, cfg))
+        {
+            return;
+        }
+        result.parsed = true;
+        result.values.reserve(configSettingPaths.size());
+        for (const std::string& configSettingPath : configSettingPaths)
+        {
+            result.values.push_back(getCommonSettingValue(cfg, configSettingPath));
+        }
+    });
+    return results;
+}
+
+void appendEscaped(std::string& out, std::string_view text)
+{
+    for (char c : text)
+    {
+        if (c == '\\')
+        {
+            out += "\\\\";
+        }
+        else if (c == '\t')
+        {
+            out += "\\t";
+        }
+        else if (c == '\n')
+        {
+            out += "\\n";
+        }
+        else
+        {
+            out += c;
+        }
+    }
+}
+
+ConfigServer::~ConfigServer()
+{
+    {
+        std::lock_guard<std::mutex> lock(queryMutex_);
+        queryReloadPending_ = false;
+    }
+    if (queryLoader_.joinable())
+    {
+        queryLoader_.join();
+    }
+    for (const Client& client : clients_)
+    {
+        close(client.fd);
+    }
+    if (listenFd_ >= 0)
+    {
+        close(listenFd_);
+        unlink(socketPath_.c_str());
+    }
+}
+
+bool ConfigServer::start()
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath_.size() >= sizeof(address.sun_path))
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, socketPath_, "socket path too long");
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath_.c_str(), socketPath_.size() + 1);
+    struct stat socketStat;
+    if (lstat(socketPath_.c_str(), &socketStat) == 0)
+    {
+        if (!S_ISSOCK(socketStat.st_mode))
+        {
+            getConfigErrorLog().report(ConfigStatus::IOError, socketPath_, "exists and is not a socket");
+            return false;
+        }
+        // The socket of a server that exited refuses connections, that of a running server accepts them or is busy
+        const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        const bool stale = probe >= 0 && connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 &&
+                           (errno == ECONNREFUSED || errno == ENOENT);
+        if (probe >= 0)
+        {
+            close(probe);
+        }
+        if (!stale)
+        {
+            getConfigErrorLog().report(ConfigStatus::IOError, socketPath_, "another server is listening on the socket");
+            return false;
+        }
+        unlink(socketPath_.c_str());
+    }
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listenFd_ < 0 || bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd_, 64) != 0)
+    {
+        getConfigErrorLog().report(ConfigStatus::IOError, socketPath_, std::strerror(errno));
+        if (listenFd_ >= 0)
+        {
+            close(listenFd_);
+            listenFd_ = -1;
+        }
+        return false;
+    }
+    reloadQueryIndex();
+    return true;
+}
+
+void ConfigServer::reloadQueryIndex()
+{
+    std::lock_guard<std::mutex> lock(queryMutex_);
+    if (queryLoading_)
+    {
+        // The files may have changed after the current load read them
+        queryReloadPending_ = true;
+        return;
+    }
+    if (queryLoader_.joinable())
+    {
+        // The previous load is done, its thread only has to return
+        queryLoader_.join();
+    }
+    queryLoading_ = true;
+    queryLoader_ = std::thread([this]()
+    {
+        for (;;)
+        {
+            std::shared_ptr<const ConfigQueryIndex> index = std::make_shared<const ConfigQueryIndex>(loadFlatConfigs(directory_, findConfigRuns(directory_)));
+            std::lock_guard<std::mutex> lock(queryMutex_);
+            queryIndex_ = std::move(index);
+            if (!queryReloadPending_)
+            {
+                queryLoading_ = false;
+                return;
+            }
+            queryReloadPending_ = false;
+        }
+    });
+}
+
+void ConfigServer::run()
+{
+    std::vector<pollfd> fds;
+    while (!stopped_)
+    {
+        fds.clear();
+        fds.push_back({listenFd_, POLLIN, 0});
+        for (const Client& client : clients_)
+        {
+            // Clients with a full buffer are not read from until their requests are answered and sent
+            const bool readable = !client.inputClosed && client.input.size() < maxClientBytes;
+            fds.push_back({client.fd, static_cast<short>((readable ? POLLIN : 0) | (client.output.empty() ? 0 : POLLOUT)), 0});
+        }
+        // Wake up regularly to notice stop()
+        if (poll(fds.data(), fds.size(), 200) <= 0)
+        {
+            continue;
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            int fd;
+            while ((fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0)
+            {
+                clients_.push_back({fd, false, std::string(), std::string()});
+            }
+        }
+        for (size_t i = 1; i < fds.size(); ++i)
+        {
+            Client& client = clients_[i - 1];
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                serve(client);
+            }
+            while (client.fd >= 0)
+            {
+                answer(client);
+                if (client.output.empty())
+                {
+                    break;
+                }
+                flush(client);
+                // Stop once the socket is full, poll() tells when it drains
+                if (client.fd < 0 || !client.output.empty())
+                {
+                    break;
+                }
+            }
+            if (client.fd >= 0 && client.inputClosed && client.output.empty())
+            {
+                close(client.fd);
+                client.fd = -1;
+            }
+        }
+        clients_.erase(std::remove_if(clients_.begin(), clients_.end(), [](const Client& client) { return client.fd < 0; }), clients_.end());
+    }
+}
+
+void ConfigServer::handleRequest(std::string_view request, std::string& response)
+{
+    std::istringstream words{std::string(request)};
+    std::string command;
+    words >> command;
+    if (command == "get")
+    {
+        int station;
+        int run;
+        if (!(words >> station >> run))
+        {
+            response += "ERR\texpected get <station> <run> <paths>\n";
+            return;
+        }
+        const FlatConfig* flat = getFlatConfig(station, run);
+        if (!flat)
+        {
+            response += "ERR\tno configuration for station" + std::to_string(station) + " run" + std::to_string(run) + "\n";
+            return;
+        }
+        response += "OK";
+        std::string path;
+        std::string value;
+        while (words >> path)
+        {
+            tryGetCommonSettingValue(*flat, path, value);
+            response += '\t';
+            appendEscaped(response, value);
+        }
+        response += '\n';
+    }
+    else if (command == "query")
+    {
+        std::string conditions;
+        std::getline(words, conditions);
+        std::vector<ConfigPredicate> predicates;
+        if (!parseConfigQuery(conditions, predicates))
+        {
+            response += "ERR\tcannot parse query\n";
+            return;
+        }
+        std::shared_ptr<const ConfigQueryIndex> index = getQueryIndex();
+        if (!index)
+        {
+            response += "ERR\tthe runs are still loading\n";
+            return;
+        }
+        response += "OK";
+        for (const ConfigRun& run : index->select(predicates))
+        {
+            response += '\t';
+            appendInteger(response, run.station);
+            response += '/';
+            appendInteger(response, run.run);
+        }
+        response += '\n';
+    }
+    else if (command == "reload")
+    {
+        reloadQueryIndex();
+        response += "OK\n";
+    }
+    else if (command == "stats")
+    {
+        ConfigCacheStats stats = getConfigCache().getStats();
+        response += "OK\t" + std::to_string(stats.hits) + "\t" + std::to_string(stats.misses) + "\t" + std::to_string(stats.entries) + "\n";
+    }
+    else
+    {
+        response += "ERR\tunknown command ";
+        appendEscaped(response, command);
+        response += '\n';
+    }
+}
+
+const FlatConfig* ConfigServer::getFlatConfig(int station, int run)
+{
+    std::shared_ptr<const libconfig::Config> config = getConfigCache().get(getConfigFilepath(station, run, directory_));
+    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(station)) << 32) | static_cast<uint32_t>(run);
+    auto it = flatConfigs_.find(key);
+    if (!config)
+    {
+        if (it != flatConfigs_.end())
+        {
+            flatLru_.erase(it->second);
+            flatConfigs_.erase(it);
+        }
+        return nullptr;
+    }
+    if (it == flatConfigs_.end())
+    {
+        if (flatConfigs_.size() >= maxFlatConfigs_ && !flatLru_.empty())
+        {
+            flatConfigs_.erase(flatLru_.back().key);
+            flatLru_.pop_back();
+        }
+        flatLru_.push_front(FlatEntry{key, nullptr, FlatConfig()});
+        it = flatConfigs_.emplace(key, flatLru_.begin()).first;
+    }
+    else
+    {
+        flatLru_.splice(flatLru_.begin(), flatLru_, it->second);
+    }
+    FlatEntry& entry = *it->second;
+    if (entry.config != config)
+    {
+        entry.config = config;
+        entry.flat = flattenConfig(*config);
+    }
+    return &entry.flat;
+}
+
+void ConfigServer::serve(Client& client)
+{
+    char buffer[65536];
+    while (client.input.size() < maxClientBytes)
+    {
+        ssize_t count = read(client.fd, buffer, sizeof(buffer));
+        if (count > 0)
+        {
+            client.input.append(buffer, static_cast<size_t>(count));
+            continue;
+        }
+        if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            // The client is done sending, it is closed once it has received all answers
+            client.inputClosed = true;
+        }
+        break;
+    }
+}
+
+void ConfigServer::answer(Client& client)
+{
+    size_t begin = 0;
+    size_t end;
+    while (client.output.size() < maxClientBytes && (end = client.input.find('\n', begin)) != std::string::npos)
+    {
+        std::string_view line(client.input.data() + begin, end - begin);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (!line.empty())
+        {
+            handleRequest(line, client.output);
+        }
+        begin = end + 1;
+    }
+    client.input.erase(0, begin);
+    if (client.input.size() >= maxClientBytes && client.input.find('\n') == std::string::npos)
+    {
+        // A request that does not fit in the buffer can never be answered
+        client.output += "ERR\trequest too long\n";
+        client.input.clear();
+        client.inputClosed = true;
+    }
+}
+
+void ConfigServer::flush(Client& client)
+{
+    while (!client.output.empty())
+    {
+        ssize_t count = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if (count <= 0)
+        {
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                close(client.fd);
+                client.fd = -1;
+            }
+            return;
+        }
+        client.output.erase(0, static_cast<size_t>(count));
+    }
+}
+
+void configReader(int station, int run, std::string directory, std::string setting_path_alias)
+{
+    return readConfigFile(station, run, directory, "radiant.scalers.period");
+}
+
+std::vector<std::string> splitSettingPaths(const std::string& setting_path_aliases)
+{
+    std::vector<std::string> paths;
+    std::stringstream ss(setting_path_aliases);
+    std::string path;
+    while (std::getline(ss, path, ','))
+    {
+        if (!path.empty())
+        {
+            paths.push_back(path);
+        }
+    }
+    return paths;
+}
+
+void configScanner(std::string directory, std::string setting_path_aliases, int nThreads)
+{
+    const std::vector<std::string> configSettingPaths = splitSettingPaths(setting_path_aliases);
+    printConfigTable(scanConfigFiles(directory, configSettingPaths, nThreads), configSettingPaths);
+}
+
+void configSnapshot(std::string snapshotPath, std::string directory, int nThreads)
+{
+    int parsed = updateConfigSnapshot(snapshotPath, directory, nThreads);
+    if (parsed >= 0)
+    {
+        ConfigSnapshot snapshot;
+        snapshot.open(snapshotPath);
+        std::cout << snapshotPath << " : " << snapshot.getRuns().size() << " runs, " << parsed << " parsed" << std::endl;
+    }
+}
+
+void configChanges(int station, int firstRun, int lastRun, std::string directory, std::string setting_path_aliases)
+{
+    const std::vector<std::string> paths = splitSettingPaths(setting_path_aliases);
+    streamConfigChanges(station, firstRun, lastRun, directory, paths, [](const ConfigChange& change)
+    {
+        std::cout << "station" << change.station << " run" << change.previousRun << " -> run" << change.run << " : " << change.path << " : ";
+        if (change.kind == ConfigChangeKind::Added)
+        {
+            std::cout << "added " << change.newValue;
+        }
+        else if (change.kind == ConfigChangeKind::Removed)
+        {
+            std::cout << "removed " << change.oldValue;
+        }
+        else
+        {
+            std::cout << change.oldValue << " -> " << change.newValue;
+        }
+        std::cout << std::endl;
+    });
+}
+
+void configQuery(std::string query, std::string directory, std::string snapshotPath)
+{
+    std::vector<SnapshotRun> runs;
+    if (!snapshotPath.empty())
+    {
+        ConfigSnapshot snapshot;
+        if (!snapshot.open(snapshotPath))
+        {
+            return;
+        }
+        runs = snapshot.getRuns();
+    }
+    else
+    {
+        const std::string root = resolveConfigPath(directory);
+        runs = loadFlatConfigs(root, findConfigRuns(root));
+    }
+    ConfigQueryIndex index(std::move(runs));
+    for (const ConfigRun& run : index.select(query))
+    {
+        std::cout << "station" << run.station << "\trun" << run.run << "\n";
+    }
+    std::cout.flush();
+}
+
+void configIndex(std::string indexPath, std::string directory, bool verifyFiles)
+{
+    ConfigLocationIndex index;
+    struct stat indexStat;
+    if (stat(resolveConfigPath(indexPath).c_str(), &indexStat) == 0)
+    {
+        index.load(indexPath);
+    }
+    int changes = index.update(directory, verifyFiles);
+    if (index.save(indexPath))
+    {
+        std::cout << indexPath << " : " << index.getLocations().size() << " runs, " << changes << " changed" << std::endl;
+    }
+}
+
+void configServer(std::string socketPath, std::string directory)
+{
+    ConfigServer server(directory, socketPath);
+    if (server.start())
+    {
+        std::cout << "Serving " << directory << " on " << socketPath << std::endl;
+        server.run();
+    }
+}
+
+void configWatch(std::string directory, std::string indexPath, std::string setting_path_aliases)
+{
+    const std::vector<std::string> paths = splitSettingPaths(setting_path_aliases);
+    ConfigLocationIndex index;
+    struct stat indexStat;
+    if (!indexPath.empty() && stat(resolveConfigPath(indexPath).c_str(), &indexStat) == 0)
+    {
+        index.load(indexPath);
+    }
+
+    ConfigWatcher watcher(directory, std::move(index));
+    ConfigWatcher::Callback print = [&paths](const ConfigUpdate& update)
+    {
+        std::cout << "station" << update.station << " run" << update.run << " : ";
+        if (update.kind == ConfigChangeKind::Added)
+        {
+            std::cout << "added";
+        }
+        else if (update.kind == ConfigChangeKind::Removed)
+        {
+            std::cout << "removed";
+        }
+        else
+        {
+            std::cout << "modified";
+        }
+        std::string value;
+        for (const std::string& path : paths)
+        {
+            if (update.config && tryGetCommonSettingValue(*update.config, path, value) == ConfigStatus::Ok)
+            {
+                std::cout << "\t" << path << " = " << value;
+            }
+        }
+        std::cout << std::endl;
+    };
+    int changes = watcher.start(print);
+    std::cout << "Watching " << directory << (watcher.usesEvents() ? "" : " by polling") << std::endl;
+    for (;;)
+    {
+        if (changes > 0 && !indexPath.empty())
+        {
+            watcher.getIndex().save(indexPath);
+        }
+        changes = watcher.poll(1000, print);
+    }
+}
+
+int configValidate(std::string schemaPath, std::string directory, int nThreads)
+{
+    ConfigSchema schema;
+    if (!schema.load(schemaPath))
+    {
+        return -1;
+    }
+    std::vector<ConfigViolation> violations = validateConfigs(schema, directory, nThreads);
+    printConfigViolations(schema, violations);
+    return static_cast<int>(violations.size());
+}
+
+void configArchive(std::string archivePath, std::string setting_path_aliases, int nThreads)
+{
+    ConfigArchive archive;
+    if (!archive.open(archivePath))
+    {
+        return;
+    }
+    const std::vector<std::string> configSettingPaths = splitSettingPaths(setting_path_aliases);
+    printConfigTable(scanConfigArchive(archive, configSettingPaths, nThreads), configSettingPaths);
+}
+
+#ifdef RNOG_CONFIG_HAVE_ROOT
+
+void configTree(std::string outputPath, std::string directory, std::string setting_path_aliases)
+{
+    const std::vector<std::string> paths = splitSettingPaths(setting_path_aliases);
+    const std::string root = resolveConfigPath(directory);
+    const std::vector<SnapshotRun> runs = loadFlatConfigs(root, findConfigRuns(root));
+    if (exportConfigTree(outputPath, runs, paths))
+    {
+        std::cout << outputPath << " : " << runs.size() << " runs" << std::endl;
+    }
+}
+
+#endif
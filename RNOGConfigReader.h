@@ -0,0 +1,4610 @@
+/*
+    Written by Joneskim Kimo, 2023
+    Declarations of the RNO-G configuration reader library. The functions read the configuration files of RNO-G runs with the
+    Libconfig library, convert the settings to strings, retrieve the settings and handle common aliases.
+
+    The definitions live in RNOGConfigReader.cxx, compiled into libRNOGConfigReader (see CMakeLists.txt) or included by the
+    configReader.C macro when it is interpreted without the library.
+*/
+
+#ifndef RNOG_CONFIG_READER_H
+#define RNOG_CONFIG_READER_H
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <libconfig.h++>
+#include <unordered_map>
+#include <map>
+#include <set>
+#include <array>
+#include <sstream>
+#include <string_view>
+#include <optional>
+#include <type_traits>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <vector>
+#include <initializer_list>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <cerrno>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#if !defined(RNOG_CONFIG_NO_ROOT) && __has_include(<TTree.h>)
+#include <TFile.h>
+#include <TTree.h>
+#define RNOG_CONFIG_HAVE_ROOT 1
+#endif
+
+#if !defined(RNOG_CONFIG_NO_ZLIB) && __has_include(<zlib.h>)
+#include <zlib.h>
+#define RNOG_CONFIG_HAVE_ZLIB 1
+#endif
+
+#if !defined(RNOG_CONFIG_NO_ZSTD) && __has_include(<zstd.h>)
+#include <zstd.h>
+#define RNOG_CONFIG_HAVE_ZSTD 1
+#endif
+
+/*
+    Appends an integer to a string, formatted like std::to_string.
+*/
+
+inline void appendInteger(std::string& out, long long value)
+{
+    char buffer[24];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+/*
+    Appends a float to a string. The fixed format matches std::to_string(float) and the general format matches std::ostream << float.
+*/
+
+inline void appendFloat(std::string& out, float value, std::chars_format format)
+{
+    char buffer[64];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, format, 6);
+    if (result.ec == std::errc())
+    {
+        out.append(buffer, result.ptr);
+    }
+    else if (format == std::chars_format::fixed)
+    {
+        out += std::to_string(value);
+    }
+    else
+    {
+        std::ostringstream ss;
+        ss << value;
+        out += ss.str();
+    }
+}
+
+/*
+    Appends an array or list to a string as "[a,b,c]" or "(a,b,c)".
+
+    The element formatter is called with the output string and the index of each element. The result is an empty string for an empty
+    array, and "[a]" for a single element.
+*/
+
+template <typename AppendElement>
+void appendElements(std::string& out, int length, char open, char close, AppendElement appendElement)
+{
+    if (length == 0)
+    {
+        return;
+    }
+    out += open;
+    for (int i = 0; i < length; ++i)
+    {
+        if (i != 0)
+        {
+            out += ',';
+        }
+        appendElement(out, i);
+    }
+    out += close;
+}
+
+/*
+    Appends the value of a libconfig Setting to a string.
+
+    This function writes the same representation as settingValueToString directly into the output string, without temporary strings
+    or streams. Reusing the output string across calls avoids any allocation once it has grown large enough.
+
+    Parameters
+    ----------
+    out : string
+        The string to append to.
+    setting : Setting
+        The setting to convert to a string representation.
+
+    Note:
+        Nothing is appended if the setting type is not supported.
+        Elements of arrays and lists other than integers and floats are written as empty.
+*/
+
+void appendSettingValue(std::string& out, const libconfig::Setting& setting);
+
+/*
+    Converts the value of libconfig Setting to a string representation.
+
+    This function is used to convert various types of setting values(integers, booleans, strings, arrays, lists, etc) to a string representation. It provides a consistent way 
+    to convert these values making it easier to handle the different types of settings.
+
+    Parameters
+    ----------
+    setting : Setting
+        The setting to convert to a string representation.
+    path :A string
+        The path to the setting. This is used to determine the type of the setting.
+
+    Returns
+    -------
+    string
+        The string representation of the setting value.
+
+    Note: 
+        The function returns an empty string if the setting type is not supported.
+        The function only supports the following types of settings: integers, booleans, strings, arrays, and lists.
+        The function uses appendSettingValue, callers converting many settings can use it directly with a reused string.
+*/
+
+std::string settingValueToString(const libconfig::Setting& setting, const std::string& path = "");
+
+/*
+
+    Counters of the time spent in configuration handling, collected when RNOG_CONFIG_INSTRUMENTATION is defined.
+
+    Members
+    -------
+    filesParsed, bytesRead : uint64_t
+        Number of configuration files or buffers parsed, and their total size.
+    parseNanoseconds : uint64_t
+        Time spent parsing them.
+    readConfigFileCalls, readConfigFileNanoseconds : uint64_t
+        Number of readConfigFile calls and their total time, including cache lookups and parsing.
+    lookups, lookupMisses : uint64_t
+        Number of getSettingValue calls, and how many of them did not find the setting.
+    commonLookups, aliasMisses : uint64_t
+        Number of getCommonSettingValue calls, and how many of them were given an unknown alias.
+    cacheHits, cacheMisses : uint64_t
+        Number of ConfigCache lookups answered from memory or by parsing the file.
+    exceptions : uint64_t
+        Number of libconfig exceptions caught, i.e. I/O and parse errors.
+*/
+
+struct ConfigInstrumentationStats
+{
+    uint64_t filesParsed = 0;
+    uint64_t bytesRead = 0;
+    uint64_t parseNanoseconds = 0;
+    uint64_t readConfigFileCalls = 0;
+    uint64_t readConfigFileNanoseconds = 0;
+    uint64_t lookups = 0;
+    uint64_t lookupMisses = 0;
+    uint64_t commonLookups = 0;
+    uint64_t aliasMisses = 0;
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t exceptions = 0;
+};
+
+/*
+
+    The time readConfigFile spent on the runs of one station, collected when RNOG_CONFIG_INSTRUMENTATION is defined.
+
+    Members
+    -------
+    station : int
+        The station number.
+    reads, nanoseconds : uint64_t
+        Number of readConfigFile calls for the station and their total time.
+    slowestRun : int
+        The run of the slowest call.
+    slowestNanoseconds : uint64_t
+        The time of the slowest call.
+*/
+
+struct ConfigStationStats
+{
+    int station = 0;
+    uint64_t reads = 0;
+    uint64_t nanoseconds = 0;
+    int slowestRun = 0;
+    uint64_t slowestNanoseconds = 0;
+};
+
+/*
+
+    The process-wide instrumentation counters.
+
+    The counters are only updated through the RNOG_CONFIG_COUNT and RNOG_CONFIG_TIME macros, which compile to nothing unless
+    RNOG_CONFIG_INSTRUMENTATION is defined before including this file. The counters are relaxed atomics, so the cost of enabled
+    instrumentation is one uncontended atomic add per event, plus two clock reads per timed call.
+*/
+
+class ConfigInstrumentation
+{
+public:
+    std::atomic<uint64_t> filesParsed{0};
+    std::atomic<uint64_t> bytesRead{0};
+    std::atomic<uint64_t> parseNanoseconds{0};
+    std::atomic<uint64_t> readConfigFileCalls{0};
+    std::atomic<uint64_t> readConfigFileNanoseconds{0};
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> lookupMisses{0};
+    std::atomic<uint64_t> commonLookups{0};
+    std::atomic<uint64_t> aliasMisses{0};
+    std::atomic<uint64_t> cacheHits{0};
+    std::atomic<uint64_t> cacheMisses{0};
+    std::atomic<uint64_t> exceptions{0};
+
+    // Returns a copy of the counters.
+    ConfigInstrumentationStats getStats() const;
+
+    // Records the time of a readConfigFile call for a run.
+    void recordRun(int station, int run, uint64_t nanoseconds);
+
+    // Returns the time spent on every station, sorted by station.
+    std::vector<ConfigStationStats> getStationStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<ConfigStationStats> stations;
+        stations.reserve(stations_.size());
+        for (const auto& entry : stations_)
+        {
+            stations.push_back(entry.second);
+        }
+        return stations;
+    }
+
+    // Sets all counters to zero.
+    void reset()
+    {
+        for (std::atomic<uint64_t>* counter : {&filesParsed, &bytesRead, &parseNanoseconds, &readConfigFileCalls, &readConfigFileNanoseconds, &lookups,
+                                               &lookupMisses, &commonLookups, &aliasMisses, &cacheHits, &cacheMisses, &exceptions})
+        {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        stations_.clear();
+    }
+
+    // Prints the counters and the time spent on every station.
+    void print(std::ostream& out = std::cout) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<int, ConfigStationStats> stations_;
+};
+
+ConfigInstrumentation& getConfigInstrumentation();
+
+/*
+    Adds the time from its construction to its destruction to a counter, and optionally to the stats of a run.
+*/
+
+class ConfigScopedTimer
+{
+public:
+    explicit ConfigScopedTimer(std::atomic<uint64_t>& counter, int station = -1, int run = -1)
+        : counter_(counter), station_(station), run_(run), start_(std::chrono::steady_clock::now()) {}
+
+    ~ConfigScopedTimer()
+    {
+        const uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        counter_.fetch_add(nanoseconds, std::memory_order_relaxed);
+        if (station_ >= 0)
+        {
+            getConfigInstrumentation().recordRun(station_, run_, nanoseconds);
+        }
+    }
+
+    ConfigScopedTimer(const ConfigScopedTimer&) = delete;
+    ConfigScopedTimer& operator=(const ConfigScopedTimer&) = delete;
+
+private:
+    std::atomic<uint64_t>& counter_;
+    int station_;
+    int run_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#ifdef RNOG_CONFIG_INSTRUMENTATION
+#define RNOG_CONFIG_COUNT(counter, amount) getConfigInstrumentation().counter.fetch_add(amount, std::memory_order_relaxed)
+#define RNOG_CONFIG_TIME(counter) ConfigScopedTimer rnogConfigTimer(getConfigInstrumentation().counter)
+#define RNOG_CONFIG_TIME_RUN(counter, station, run) ConfigScopedTimer rnogConfigTimer(getConfigInstrumentation().counter, station, run)
+#else
+#define RNOG_CONFIG_COUNT(counter, amount) ((void)0)
+#define RNOG_CONFIG_TIME(counter) ((void)0)
+#define RNOG_CONFIG_TIME_RUN(counter, station, run) ((void)0)
+#endif
+
+/*
+
+    Prints the instrumentation counters periodically on a background thread, e.g. to follow a production job.
+
+    Example:
+        ConfigInstrumentationDump dump(std::cerr, 60);   // prints every minute until dump is destroyed
+*/
+
+class ConfigInstrumentationDump
+{
+public:
+    ConfigInstrumentationDump(std::ostream& out, double intervalSeconds)
+        : out_(out), interval_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(intervalSeconds)))
+    {
+        worker_ = std::thread([this]()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopped_.wait_for(lock, interval_, [this]() { return stop_; }))
+            {
+                getConfigInstrumentation().print(out_);
+            }
+        });
+    }
+
+    ~ConfigInstrumentationDump()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        stopped_.notify_all();
+        worker_.join();
+    }
+
+    ConfigInstrumentationDump(const ConfigInstrumentationDump&) = delete;
+    ConfigInstrumentationDump& operator=(const ConfigInstrumentationDump&) = delete;
+
+private:
+    std::ostream& out_;
+    std::chrono::steady_clock::duration interval_;
+    std::mutex mutex_;
+    std::condition_variable stopped_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+/*
+
+    Status of a configuration lookup or read.
+*/
+
+enum class ConfigStatus
+{
+    Ok,
+    NotFound,
+    TypeMismatch,
+    UnknownAlias,
+    IOError,
+    ParseError,
+    InvalidFormat
+};
+
+// Returns a short description of a status, as used in error messages.
+const char* configStatusMessage(ConfigStatus status);
+
+/*
+
+    The number of times an error occurred, as collected by ConfigErrorLog.
+
+    Members
+    -------
+    status : ConfigStatus
+        The kind of error.
+    key : string
+        What the error is about: the path, alias or file.
+    count : size_t
+        The number of times it occurred.
+    detail : string
+        Details of the first occurrence, e.g. the line of a parse error.
+*/
+
+struct ConfigErrorCount
+{
+    ConfigStatus status = ConfigStatus::Ok;
+    std::string key;
+    size_t count = 0;
+    std::string detail;
+};
+
+/*
+
+    Collects and rate-limits the errors of the reader functions.
+
+    The functions that return an empty string on failure (getSettingValue, getCommonSettingValue, readConfigFile, ...) report their
+    errors here instead of printing each one. Every distinct error (status and key) is counted, and only its first occurrences are
+    printed, up to a total number of printed lines, so scans over runs that lack newer settings do not flood the output. The counts
+    can be read back as a summary.
+
+    Note:
+        The log is thread-safe. The functions returning a ConfigStatus (tryGetSettingValue, ...) do not report to it.
+*/
+
+class ConfigErrorLog
+{
+public:
+    // Records an error, and prints it if the print limits allow.
+    void report(ConfigStatus status, std::string_view key, std::string_view detail = std::string_view());
+
+    /*
+        Sets how many times each distinct error is printed and how many errors are printed in total. The defaults are 1 and 100.
+    */
+    void setPrintLimits(size_t printsPerError, size_t maxPrints)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        printsPerError_ = printsPerError;
+        maxPrints_ = maxPrints;
+    }
+
+    // Sets the stream errors are printed to, std::cout by default. A null pointer only collects them.
+    void setOutput(std::ostream* output)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        output_ = output;
+    }
+
+    // Returns the errors collected so far, most frequent first.
+    std::vector<ConfigErrorCount> getSummary() const;
+
+    // Returns the total number of errors reported.
+    size_t getTotalCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return totalCount_;
+    }
+
+    // Prints one line per distinct error with its count.
+    void printSummary(std::ostream& out = std::cout) const;
+
+    // Forgets all collected errors and restarts the print limits.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        errors_.clear();
+        totalCount_ = 0;
+        printed_ = 0;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, ConfigErrorCount> errors_;
+    std::ostream* output_ = &std::cout;
+    size_t printsPerError_ = 1;
+    size_t maxPrints_ = 100;
+    size_t printed_ = 0;
+    size_t totalCount_ = 0;
+};
+
+/*
+    Returns the process-wide error log of the reader functions.
+*/
+
+ConfigErrorLog& getConfigErrorLog();
+
+/*
+
+    Visits a setting and, for groups, all the settings nested in it, without building any strings.
+
+    The visitor is an object with the member functions
+        bool enterGroup(const libconfig::Setting& group, int depth)
+        void leaveGroup(const libconfig::Setting& group, int depth)
+        void visitValue(const libconfig::Setting& setting, int depth)
+    enterGroup returns false to skip the children of a group. leaveGroup is only called for groups that were entered. The names of
+    the settings are available without copies through libconfig::Setting::getName.
+
+    Parameters
+    ----------
+    setting : Setting
+        The setting to visit.
+    visitor : Visitor
+        The visitor.
+    depth : int
+        The depth reported for the setting. Children are reported one level deeper.
+*/
+
+template <typename Visitor>
+void visitSetting(const libconfig::Setting& setting, Visitor& visitor, int depth = 0)
+{
+    if (setting.getType() != libconfig::Setting::TypeGroup)
+    {
+        visitor.visitValue(setting, depth);
+        return;
+    }
+    if (!visitor.enterGroup(setting, depth))
+    {
+        return;
+    }
+    for (int i = 0; i < setting.getLength(); ++i)
+    {
+        visitSetting(setting[i], visitor, depth + 1);
+    }
+    visitor.leaveGroup(setting, depth);
+}
+
+/*
+
+    Estimates the length of the string representation of a setting, so that renderSetting can size its buffer once.
+*/
+
+size_t estimateRenderedSize(const libconfig::Setting& setting);
+
+/*
+
+    Appends the string representation of a group to a string.
+
+    The group is written as "{\nname = value, \nname = value\n}", with nested groups written the same way in place of their value.
+    Nothing is appended for an empty group.
+*/
+
+void appendGroupValue(std::string& out, const libconfig::Setting& group);
+
+/*
+
+    Renders a setting, group or value, to its string representation.
+
+    The output buffer is sized once from estimateRenderedSize and every value is written straight into it, so large groups are
+    rendered without temporary strings.
+
+    Parameters
+    ----------
+    setting : Setting
+        The setting to render.
+
+    Returns
+    -------
+    string
+        The string representation of the setting, as returned by getSettingValue.
+*/
+
+std::string renderSetting(const libconfig::Setting& setting);
+
+/*
+
+    Finds a setting by its path, walking the tree once without throwing.
+
+    Parameters
+    ----------
+    root : Setting
+        The setting the path starts from, usually the root of a configuration.
+    path : string_view
+        The path, in the syntax of libconfig: names separated by '.', ':' or '/', and [n] for the element at index n.
+
+    Returns
+    -------
+    pointer to Setting
+        The setting, or a null pointer if the path leads to none.
+
+    Note:
+        Checking with exists() before lookup() walks the path twice, and lookup() alone throws for missing settings. The walk follows
+        config_setting_lookup of libconfig 1.7, so the path finds the same setting as exists() and lookup() of that version, which
+        tests/findSettingTest.cxx checks; only indexes beyond the range of an int, which libconfig wraps around, find nothing here.
+*/
+
+const libconfig::Setting* findSetting(const libconfig::Setting& root, std::string_view path);
+
+/*
+
+    Retrieves the value of a setting from the configuration file without throwing or reporting errors.
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+    path :A string
+        The path to the setting.
+    value : string
+        Set to the string representation of the setting value, or cleared if the setting does not exist.
+
+    Returns
+    -------
+    ConfigStatus
+        Ok, or NotFound if the setting does not exist.
+*/
+
+ConfigStatus tryGetSettingValue(const libconfig::Config& config, const std::string& path, std::string& value);
+
+/*
+
+    Retrieves the value of a setting from the configuration file.
+
+    This function allows retrieving the value of a setting from the configuration file. It uses the libconfig library to read the configuration file and retrieve the value
+    of the setting. It also handles the case where the setting is a group of settings. If the setting is a group it traverses the group and retrieves the value of each setting
+    in the group, including nested groups, and returns a string representation of the group (see appendGroupValue).
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+    path :A string
+        The path to the setting. This is used to determine the type of the setting.
+
+    Returns
+    -------
+    string
+        The string representation of the setting value.
+
+    Note:
+        The function returns an empty string if the setting type is not supported.
+        The function only supports the following types of settings: integers, booleans, strings, arrays, and lists.
+        The function uses the renderSetting function to convert the setting value to a string representation.
+        Callers that only need to walk a group can use visitSetting instead, which builds no strings.
+        Missing settings are reported to the error log, see getConfigErrorLog. Use tryGetSettingValue to check for them instead.
+*/
+
+std::string getSettingValue(const libconfig::Config& config, const std::string& path);
+
+
+/*
+
+    A common setting alias and the path of the setting it stands for.
+*/
+
+struct CommonSettingAlias
+{
+    std::string_view alias;
+    std::string_view path;
+};
+
+/*
+
+    The built-in common setting aliases, sorted by alias.
+
+    The table covers the RADIANT trigger, scaler, servo, threshold and readout settings and the settings of the low-threshold trigger
+    board (LT, also known as the flower board), which live in the lt group of acq.cfg.
+    Keep the table sorted when adding aliases, it is checked at compile time.
+*/
+
+constexpr std::array<CommonSettingAlias, 39> commonSettingAliases = {{
+    {"ext_trigger_enabled", "radiant.trigger.ext.enabled"},
+    {"lt_device", "lt.device.spi_device"},
+    {"lt_gain_auto_gain", "lt.gain.auto_gain"},
+    {"lt_gain_fixed_gain_codes", "lt.gain.fixed_gain_codes"},
+    {"lt_gain_target_rms", "lt.gain.target_rms"},
+    {"lt_servo_enable", "lt.servo.enable"},
+    {"lt_servo_scaler_goal", "lt.servo.scaler_goal"},
+    {"lt_servo_subtract_gated", "lt.servo.subtract_gated"},
+    {"lt_thresholds_initial", "lt.thresholds.initial"},
+    {"lt_trigger_enabled", "lt.trigger.enable"},
+    {"lt_trigger_min_coincidence", "lt.trigger.min_coincidence"},
+    {"lt_trigger_vpp", "lt.trigger.vpp"},
+    {"lt_trigger_window", "lt.trigger.window"},
+    {"pps_trigger_enabled", "radiant.trigger.pps.enabled"},
+    {"pps_trigger_output_enabled", "radiant.trigger.pps.output_enabled"},
+    {"readout_mask", "radiant.readout.readout_mask"},
+    {"readout_nbuffers_per_readout", "radiant.readout.nbuffers_per_readout"},
+    {"readout_poll_ms", "radiant.readout.poll_ms"},
+    {"rf0_enabled", "radiant.trigger.RF0.enabled"},
+    {"rf0_mask", "radiant.trigger.RF0.mask"},
+    {"rf0_num_coincidences", "radiant.trigger.RF0.num_coincidences"},
+    {"rf0_window", "radiant.trigger.RF0.window"},
+    {"rf1_enabled", "radiant.trigger.RF1.enabled"},
+    {"rf1_mask", "radiant.trigger.RF1.mask"},
+    {"rf1_num_coincidences", "radiant.trigger.RF1.num_coincidences"},
+    {"rf1_window", "radiant.trigger.RF1.window"},
+    {"scalers_period", "radiant.scalers.period"},
+    {"scalers_prescal_m1", "radiant.scalers.prescal_m1"},
+    {"scalers_use_pps", "radiant.scalers.use_pps"},
+    {"servo_enable", "radiant.servo.enable"},
+    {"servo_scaler_goals", "radiant.servo.scaler_goals"},
+    {"soft_trigger_enabled", "radiant.trigger.soft.enabled"},
+    {"soft_trigger_interval", "radiant.trigger.soft.interval"},
+    {"thresholds_initial", "radiant.thresholds.initial"},
+    {"thresholds_load_from_file", "radiant.thresholds.load_from_threshold_file"},
+    {"thresholds_max", "radiant.thresholds.max"},
+    {"thresholds_min", "radiant.thresholds.min"},
+    {"trigger_clear_mode", "radiant.trigger.clear_mode"},
+    {"trigger_output_enabled", "radiant.trigger.output_enabled"}
+}};
+
+constexpr bool isSortedAliasTable()
+{
+    for (size_t i = 1; i < commonSettingAliases.size(); ++i)
+    {
+        if (!(commonSettingAliases[i - 1].alias < commonSettingAliases[i].alias))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isSortedAliasTable(), "commonSettingAliases must be sorted by alias and free of duplicates");
+
+/*
+
+    Finds the path of a built-in common setting alias.
+
+    This function is constexpr, so aliases given as literals are resolved at compile time, e.g.
+        constexpr std::string_view rf0Path = findCommonSettingPath("rf0_enabled");
+
+    Parameters
+    ----------
+    alias :A string
+        The alias of the common setting.
+
+    Returns
+    -------
+    string_view
+        The path to the setting, or an empty string if the alias is not built in.
+*/
+
+constexpr std::string_view findCommonSettingPath(std::string_view alias)
+{
+    size_t first = 0;
+    size_t last = commonSettingAliases.size();
+    while (first < last)
+    {
+        size_t middle = first + (last - first) / 2;
+        if (commonSettingAliases[middle].alias < alias)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    if (first < commonSettingAliases.size() && commonSettingAliases[first].alias == alias)
+    {
+        return commonSettingAliases[first].path;
+    }
+    return std::string_view();
+}
+
+static_assert(findCommonSettingPath("rf0_enabled") == "radiant.trigger.RF0.enabled", "alias table lookup is broken");
+
+/*
+    Storage of the aliases added with registerCommonSettingAlias.
+*/
+
+struct UserSettingAliases
+{
+    std::shared_mutex mutex;
+    std::map<std::string, std::string, std::less<>> aliases;
+    std::atomic<bool> empty{true};
+};
+
+UserSettingAliases& getUserSettingAliases();
+
+/*
+
+    Adds a common setting alias at runtime, e.g. for station specific settings.
+
+    Parameters
+    ----------
+    alias :A string
+        The alias of the setting. It must not contain a dot, since names with a dot are taken as paths.
+    path :A string
+        The path to the setting.
+
+    Returns
+    -------
+    bool
+        True if the alias was added, false if it is already defined (built in or registered before) or contains a dot.
+*/
+
+bool registerCommonSettingAlias(const std::string& alias, const std::string& path);
+
+// Adds several common setting aliases at runtime, see registerCommonSettingAlias. Returns the number of aliases added.
+size_t registerCommonSettingAliases(const std::vector<std::pair<std::string, std::string>>& aliases);
+
+/*
+
+    Resolves a common setting alias, built in or registered with registerCommonSettingAlias.
+
+    Parameters
+    ----------
+    alias :A string
+        The alias of the common setting.
+
+    Returns
+    -------
+    string_view
+        The path to the setting, or an empty string if the alias is unknown. The path stays valid for the lifetime of the process.
+
+    Note:
+        Built-in aliases are found without locking or allocating. Registered aliases are only looked up if any were registered.
+*/
+
+std::string_view resolveCommonSettingAlias(std::string_view alias);
+
+/*
+    Compact identifier of an interned setting path, see SettingPathPool.
+*/
+
+typedef uint32_t SettingPathId;
+
+constexpr SettingPathId invalidSettingPathId = std::numeric_limits<SettingPathId>::max();
+
+/*
+
+    Process-wide pool of interned setting paths.
+
+    The dotted paths found in RNO-G configurations are a small and fixed set, so every distinct path is stored once and handed out
+    as a compact integer ID. Code that keeps, compares or hashes paths across many runs (the configuration store, the query index)
+    stores IDs instead of strings. A lookup in a libconfig tree by ID walks the interned path like a lookup by string, so IDs make paths
+    cheap to keep and compare, not lookups faster.
+
+    Note:
+        Interned paths are never freed, their views stay valid for the lifetime of the process. Intern paths read from configurations
+        or aliases, not arbitrary user input.
+        The pool is thread-safe.
+*/
+
+class SettingPathPool
+{
+public:
+    // Returns the ID of a path, adding the path to the pool if it is new.
+    SettingPathId intern(std::string_view path);
+
+    // Returns the ID of a path, or invalidSettingPathId if the path was never interned.
+    SettingPathId find(std::string_view path) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(path);
+        return it != ids_.end() ? it->second : invalidSettingPathId;
+    }
+
+    // Returns the path of a valid ID. The view is null-terminated.
+    std::string_view getPath(SettingPathId id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return paths_[id];
+    }
+
+    size_t size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return paths_.size();
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    // A deque never moves its elements, so the views in ids_ and those handed out stay valid
+    std::deque<std::string> paths_;
+    std::unordered_map<std::string_view, SettingPathId> ids_;
+};
+
+SettingPathPool& getSettingPathPool();
+
+/*
+
+    Resolves a common setting alias or a path to the ID of its interned path.
+
+    Parameters
+    ----------
+    alias :A string
+        The alias of the common setting, or a path to a setting.
+
+    Returns
+    -------
+    SettingPathId
+        The ID of the path, or invalidSettingPathId if the alias is unknown or the path was never interned.
+
+    Note:
+        The paths of aliases are interned, a path given directly is only looked up in the pool, so that paths from users and clients
+        do not grow it. Intern such a path with SettingPathPool::intern to get an ID for it.
+*/
+
+SettingPathId resolveCommonSettingId(std::string_view alias);
+
+/*
+
+    Retrieves the value of a setting by the ID of its path without throwing or reporting errors, see tryGetSettingValue.
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+    id : SettingPathId
+        The ID of the path, from SettingPathPool or resolveCommonSettingId.
+    value : string
+        Set to the string representation of the setting value, or cleared on failure.
+
+    Returns
+    -------
+    ConfigStatus
+        Ok, or NotFound if the setting does not exist or the ID is invalid.
+*/
+
+ConfigStatus tryGetSettingValue(const libconfig::Config& config, SettingPathId id, std::string& value);
+
+// Retrieves the value of a setting by the ID of its path, reporting errors like getSettingValue.
+std::string getSettingValue(const libconfig::Config& config, SettingPathId id);
+
+/*
+    Retrieves the value of a common setting from the configuration file.
+
+    This function allows retrieving the value of a common setting from the configuration file. The aliases are the built-in ones of
+    commonSettingAliases and those added with registerCommonSettingAlias.
+    It uses the libconfig library to read the configuration file and retrieve the value of the setting.
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+    alias :A string
+        The alias of the common setting. The alias is used to determine the path to the setting.
+
+    Returns
+    -------
+    string
+        The string representation of the setting value.
+
+    Note:
+        The function returns an empty string if the setting type is not supported.
+        The function only supports the following types of settings: integers, booleans, strings, arrays, and lists.
+        The function uses the settingValueToString function to convert the setting value to a string representation.
+*/
+
+
+std::string getCommonSettingValue(const libconfig::Config& config, const std::string& alias);
+
+/*
+
+    Retrieves the value of a common setting without throwing or reporting errors.
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+    alias :A string
+        The alias of the common setting, or a path to a setting.
+    value : string
+        Set to the string representation of the setting value, or cleared on failure.
+
+    Returns
+    -------
+    ConfigStatus
+        Ok, NotFound if the setting does not exist or UnknownAlias if the alias is unknown.
+*/
+
+ConfigStatus tryGetCommonSettingValue(const libconfig::Config& config, const std::string& alias, std::string& value);
+
+/*
+
+    Type of a value in a FlatConfig. Mirrors libconfig::Setting::Type.
+*/
+
+enum class FlatType : uint8_t
+{
+    None,
+    Int,
+    Int64,
+    Float,
+    Boolean,
+    String,
+    Group,
+    Array,
+    List
+};
+
+/*
+
+    An unboxed value of a FlatConfig.
+
+    The member of the union in use is given by the type: intValue for Int and Int64, floatValue for Float, boolValue for Boolean,
+    text for String (an offset and length into the string storage of the FlatConfig) and elements for Array and List (an offset and
+    count into the element storage of the FlatConfig). Groups and None hold no value.
+*/
+
+struct FlatValue
+{
+    struct Range
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    FlatType type = FlatType::None;
+    uint8_t reserved[7] = {};
+    union
+    {
+        long long intValue;
+        double floatValue;
+        bool boolValue;
+        Range text;
+        Range elements;
+    };
+
+    FlatValue() : intValue(0) {}
+};
+
+/*
+
+    A setting of a FlatConfig.
+
+    Members
+    -------
+    pathOffset, pathLength : uint32_t
+        The full dotted path of the setting in the string storage of the FlatConfig.
+    nameOffset : uint32_t
+        The offset of the name of the setting within its path.
+    end : uint32_t
+        The index one past the last descendant of the setting. The children of a group start right after it, and each
+        child is followed by its next sibling at the child's end.
+    value : FlatValue
+        The value of the setting.
+*/
+
+struct FlatSetting
+{
+    uint32_t pathOffset = 0;
+    uint32_t pathLength = 0;
+    uint32_t nameOffset = 0;
+    uint32_t end = 0;
+    FlatValue value;
+};
+
+// The layout of FlatValue and FlatSetting is stored as is in configuration snapshots, see writeConfigSnapshot.
+static_assert(sizeof(FlatValue) == 16 && sizeof(FlatSetting) == 32, "FlatValue and FlatSetting must keep their snapshot layout");
+static_assert(std::is_trivially_copyable<FlatSetting>::value, "FlatSetting must be trivially copyable");
+
+/*
+
+    A parsed configuration flattened into contiguous tables.
+
+    The settings are stored depth-first in file order, together with an index sorted by path. Lookups are a binary search over the
+    sorted index that neither allocates nor throws, which makes them much cheaper than libconfig::Config::lookup when many settings
+    are read from the same configuration.
+
+    A FlatConfig is an immutable view of its tables and shares ownership of the memory holding them, which is either built by
+    flattenConfig, packed together with other runs by packFlatConfigs or mapped from a configuration snapshot. Copies are cheap and
+    share the same tables.
+
+    Note:
+        Elements of arrays and lists are stored as scalar values. Groups, arrays and lists nested inside a list are kept as elements
+        of type None, which render as empty, like in settingValueToString.
+*/
+
+class FlatConfig
+{
+public:
+    FlatConfig() = default;
+
+    /*
+        Makes a FlatConfig viewing tables held in storage.
+
+        Parameters
+        ----------
+        storage : shared_ptr
+            The owner of the memory of the tables, kept alive as long as the FlatConfig or any copy of it exists.
+        settings, settingsSize : FlatSetting
+            The settings in depth-first order.
+        sorted : uint32_t
+            The indices of the settings sorted by path, settingsSize of them.
+        elements, elementsSize : FlatValue
+            The elements of all arrays and lists.
+        strings, stringsSize : char
+            The paths and string values.
+    */
+    FlatConfig(std::shared_ptr<const void> storage, const FlatSetting* settings, uint32_t settingsSize, const uint32_t* sorted,
+               const FlatValue* elements, uint32_t elementsSize, const char* strings, uint32_t stringsSize)
+        : storage_(std::move(storage)), settings_(settings), sorted_(sorted), elements_(elements), strings_(strings),
+          settingsSize_(settingsSize), elementsSize_(elementsSize), stringsSize_(stringsSize)
+    {
+    }
+
+    // Returns the setting at the dotted path, or a null pointer if there is none.
+    const FlatSetting* find(std::string_view path) const noexcept;
+
+    std::string_view getPath(const FlatSetting& setting) const noexcept
+    {
+        return std::string_view(strings_ + setting.pathOffset, setting.pathLength);
+    }
+
+    std::string_view getName(const FlatSetting& setting) const noexcept
+    {
+        return getPath(setting).substr(setting.nameOffset);
+    }
+
+    // Returns the text of a String value.
+    std::string_view getString(const FlatValue& value) const noexcept
+    {
+        return std::string_view(strings_ + value.text.offset, value.text.length);
+    }
+
+    // Returns the first element of an Array or List value. The number of elements is value.elements.length.
+    const FlatValue* getElements(const FlatValue& value) const noexcept
+    {
+        return elements_ + value.elements.offset;
+    }
+
+    // Returns the index of a setting of this FlatConfig, to use with operator[] and FlatSetting::end.
+    uint32_t indexOf(const FlatSetting& setting) const noexcept
+    {
+        return static_cast<uint32_t>(&setting - settings_);
+    }
+
+    size_t size() const noexcept
+    {
+        return settingsSize_;
+    }
+
+    bool empty() const noexcept
+    {
+        return settingsSize_ == 0;
+    }
+
+    const FlatSetting& operator[](size_t index) const noexcept
+    {
+        return settings_[index];
+    }
+
+    // Returns the setting at a position of the index sorted by path, for 0 <= position < size().
+    const FlatSetting& getSorted(size_t position) const noexcept
+    {
+        return settings_[sorted_[position]];
+    }
+
+    // Raw tables, used to store the FlatConfig in a snapshot.
+    const FlatSetting* getSettingsData() const noexcept { return settings_; }
+    const uint32_t* getSortedData() const noexcept { return sorted_; }
+    const FlatValue* getElementsData() const noexcept { return elements_; }
+    size_t getElementsSize() const noexcept { return elementsSize_; }
+    const char* getStringsData() const noexcept { return strings_; }
+    size_t getStringsSize() const noexcept { return stringsSize_; }
+
+private:
+    std::shared_ptr<const void> storage_;
+    const FlatSetting* settings_ = nullptr;
+    const uint32_t* sorted_ = nullptr;
+    const FlatValue* elements_ = nullptr;
+    const char* strings_ = nullptr;
+    uint32_t settingsSize_ = 0;
+    uint32_t elementsSize_ = 0;
+    uint32_t stringsSize_ = 0;
+};
+
+/*
+
+    The tables of a FlatConfig built by flattenConfig, in the order they are filled.
+*/
+
+struct FlatConfigTables
+{
+    std::vector<FlatSetting> settings;
+    std::vector<uint32_t> sorted;
+    std::vector<FlatValue> elements;
+    std::string strings;
+
+    uint32_t addString(const char* text, size_t length)
+    {
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(text, length);
+        return offset;
+    }
+
+    FlatValue makeScalar(const libconfig::Setting& setting);
+
+    void add(const libconfig::Setting& setting, std::string& path);
+
+    // Sorts the index by path once all settings are added.
+    void sortIndex();
+
+    // Copies a value of another FlatConfig into these tables, together with its text or elements.
+    FlatValue copyValue(const FlatConfig& source, const FlatValue& value);
+
+    // Adds a copy of a setting of another FlatConfig as a leaf, i.e. without the children of a group.
+    void addCopy(const FlatConfig& source, const FlatSetting& setting)
+    {
+        std::string_view path = source.getPath(setting);
+        FlatSetting copy;
+        copy.pathOffset = addString(path.data(), path.size());
+        copy.pathLength = setting.pathLength;
+        copy.nameOffset = setting.nameOffset;
+        copy.value = copyValue(source, setting.value);
+        settings.push_back(copy);
+        settings.back().end = static_cast<uint32_t>(settings.size());
+    }
+
+    // Makes a FlatConfig that takes ownership of the tables.
+    static FlatConfig makeFlatConfig(std::shared_ptr<FlatConfigTables> tables)
+    {
+        const FlatConfigTables& t = *tables;
+        return FlatConfig(tables, t.settings.data(), static_cast<uint32_t>(t.settings.size()), t.sorted.data(),
+                          t.elements.data(), static_cast<uint32_t>(t.elements.size()), t.strings.data(), static_cast<uint32_t>(t.strings.size()));
+    }
+};
+
+/*
+
+    Flattens a parsed configuration into a FlatConfig.
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+
+    Returns
+    -------
+    FlatConfig
+        The flattened configuration.
+*/
+
+FlatConfig flattenConfig(const libconfig::Config& config);
+
+/*
+
+    Appends a value of a FlatConfig to a string.
+
+    This function writes the same representation as appendSettingValue for the corresponding libconfig Setting.
+
+    Parameters
+    ----------
+    out : string
+        The string to append to.
+    flat : FlatConfig
+        The configuration the value belongs to.
+    value : FlatValue
+        The value to convert.
+
+    Note:
+        Nothing is appended for groups and unsupported types.
+*/
+
+void appendFlatValue(std::string& out, const FlatConfig& flat, const FlatValue& value);
+
+// Converts a value of a FlatConfig to a string representation, see appendFlatValue.
+std::string flatValueToString(const FlatConfig& flat, const FlatValue& value);
+
+/*
+
+    Visits a setting of a flattened configuration and, for groups, all the settings nested in it, like visitSetting.
+
+    The visitor is an object with the member functions
+        bool enterGroup(const FlatConfig& flat, const FlatSetting& group, int depth)
+        void leaveGroup(const FlatConfig& flat, const FlatSetting& group, int depth)
+        void visitValue(const FlatConfig& flat, const FlatSetting& setting, int depth)
+*/
+
+template <typename Visitor>
+void visitFlatSetting(const FlatConfig& flat, const FlatSetting& setting, Visitor& visitor, int depth = 0)
+{
+    if (setting.value.type != FlatType::Group)
+    {
+        visitor.visitValue(flat, setting, depth);
+        return;
+    }
+    if (!visitor.enterGroup(flat, setting, depth))
+    {
+        return;
+    }
+    for (uint32_t i = flat.indexOf(setting) + 1; i < setting.end; i = flat[i].end)
+    {
+        visitFlatSetting(flat, flat[i], visitor, depth + 1);
+    }
+    visitor.leaveGroup(flat, setting, depth);
+}
+
+/*
+
+    Appends the string representation of a group of a flattened configuration to a string, like appendGroupValue.
+*/
+
+void appendFlatGroupValue(std::string& out, const FlatConfig& flat, const FlatSetting& group);
+
+/*
+
+    Retrieves the value of a setting from a flattened configuration without reporting errors, see tryGetSettingValue.
+*/
+
+ConfigStatus tryGetSettingValue(const FlatConfig& flat, std::string_view path, std::string& value);
+
+/*
+
+    Retrieves the value of a setting from a flattened configuration.
+
+    This function gives the same result as getSettingValue on the configuration the FlatConfig was made from, without walking the
+    libconfig tree or throwing exceptions.
+
+    Parameters
+    ----------
+    flat : FlatConfig
+        The flattened configuration that contains the settings.
+    path :A string
+        The path to the setting.
+
+    Returns
+    -------
+    string
+        The string representation of the setting value, or an empty string if the setting does not exist.
+*/
+
+std::string getSettingValue(const FlatConfig& flat, std::string_view path);
+
+// Retrieves the value of a setting of a flattened configuration by the ID of its path, see SettingPathPool.
+ConfigStatus tryGetSettingValue(const FlatConfig& flat, SettingPathId id, std::string& value);
+
+std::string getSettingValue(const FlatConfig& flat, SettingPathId id);
+
+/*
+
+    Retrieves the value of a common setting from a flattened configuration.
+
+    Parameters
+    ----------
+    flat : FlatConfig
+        The flattened configuration that contains the settings.
+    alias :A string
+        The alias of the common setting, or a path to a setting.
+
+    Returns
+    -------
+    string
+        The string representation of the setting value, or an empty string if the alias or setting is unknown.
+*/
+
+std::string getCommonSettingValue(const FlatConfig& flat, const std::string& alias);
+
+// Retrieves the value of a common setting of a flattened configuration without reporting errors, see tryGetCommonSettingValue.
+ConfigStatus tryGetCommonSettingValue(const FlatConfig& flat, const std::string& alias, std::string& value);
+/*
+
+    Compares two values of flattened configurations.
+
+    Parameters
+    ----------
+    a, b : FlatConfig
+        The configurations the values belong to.
+    x, y : FlatValue
+        The values to compare.
+
+    Returns
+    -------
+    bool
+        True if the values have the same type and value. Arrays and lists are compared element by element, groups are always equal
+        since their children are compared separately.
+*/
+
+bool flatValuesEqual(const FlatConfig& a, const FlatValue& x, const FlatConfig& b, const FlatValue& y);
+
+/*
+    Checks whether two settings have the same path. Configurations packed together or read from one snapshot share their string
+    table, in which every path is stored once, so their paths compare by offset without comparing the text.
+*/
+
+inline bool sameFlatPath(const FlatConfig& a, const FlatSetting& x, const FlatConfig& b, const FlatSetting& y)
+{
+    if (x.pathLength != y.pathLength)
+    {
+        return false;
+    }
+    if (x.pathOffset == y.pathOffset && a.getStringsData() == b.getStringsData())
+    {
+        return true;
+    }
+    return a.getPath(x) == b.getPath(y);
+}
+
+/*
+
+    Walks two flattened configurations in lockstep and reports the settings that differ.
+
+    The sorted indices of both configurations are merged, so the comparison is linear in the number of settings and needs no memory
+    besides the two configurations.
+
+    Parameters
+    ----------
+    before, after : FlatConfig
+        The configurations to compare.
+    changed : function
+        Called in path order as changed(beforeSetting, afterSetting) for every setting that differs. beforeSetting is a null pointer
+        for settings only in after, and afterSetting for settings only in before. Groups are reported only when they appear,
+        disappear or change type, their children are reported separately.
+*/
+
+template <typename Callback>
+void diffFlatConfigs(const FlatConfig& before, const FlatConfig& after, Callback changed)
+{
+    size_t i = 0;
+    size_t j = 0;
+    while (i < before.size() || j < after.size())
+    {
+        if (i < before.size() && j < after.size() && sameFlatPath(before, before.getSorted(i), after, after.getSorted(j)))
+        {
+            const FlatSetting& x = before.getSorted(i++);
+            const FlatSetting& y = after.getSorted(j++);
+            if (!flatValuesEqual(before, x.value, after, y.value))
+            {
+                changed(&x, &y);
+            }
+        }
+        else if (j == after.size() || (i < before.size() && before.getPath(before.getSorted(i)) < after.getPath(after.getSorted(j))))
+        {
+            changed(&before.getSorted(i++), static_cast<const FlatSetting*>(nullptr));
+        }
+        else
+        {
+            changed(static_cast<const FlatSetting*>(nullptr), &after.getSorted(j++));
+        }
+    }
+}
+
+/*
+
+    Calls a function with the path of every setting that differs between two flattened configurations, see diffFlatConfigs.
+*/
+
+template <typename Callback>
+void forEachChangedPath(const FlatConfig& before, const FlatConfig& after, Callback changed)
+{
+    diffFlatConfigs(before, after, [&](const FlatSetting* x, const FlatSetting* y)
+    {
+        changed(x ? before.getPath(*x) : after.getPath(*y));
+    });
+}
+
+
+/*
+
+    Helpers of getSetting to detect std::vector types and reject unsupported types at compile time.
+*/
+
+template <typename T>
+struct IsSettingVector : std::false_type {};
+
+template <typename T, typename Allocator>
+struct IsSettingVector<std::vector<T, Allocator>> : std::true_type {};
+
+template <typename T>
+struct UnsupportedSettingType : std::false_type {};
+
+/*
+
+    Converts a libconfig Setting to a C++ type without going through a string representation.
+
+    Supported types are bool, integer types (int, int64_t, ...), floating point types, std::string and std::vector of any of these
+    for arrays and lists. Other types fail to compile.
+
+    Parameters
+    ----------
+    setting : Setting
+        The setting to convert.
+
+    Returns
+    -------
+    optional
+        The converted value, or no value if the setting has an incompatible type or does not fit in T.
+
+    Note:
+        Integers convert to integer types when they are in range, and to floating point types. Floats only convert to floating point
+        types and booleans only to bool.
+*/
+
+template <typename T>
+std::optional<T> convertSetting(const libconfig::Setting& setting)
+{
+    const libconfig::Setting::Type type = setting.getType();
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        if (type == libconfig::Setting::TypeBoolean)
+        {
+            return static_cast<bool>(setting);
+        }
+        return std::nullopt;
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        long long value;
+        if (type == libconfig::Setting::TypeInt)
+        {
+            value = static_cast<int>(setting);
+        }
+        else if (type == libconfig::Setting::TypeInt64)
+        {
+            value = static_cast<long long>(setting);
+        }
+        else
+        {
+            return std::nullopt;
+        }
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (value < static_cast<long long>(std::numeric_limits<T>::min()) || value > static_cast<long long>(std::numeric_limits<T>::max()))
+            {
+                return std::nullopt;
+            }
+        }
+        else
+        {
+            if (value < 0 || static_cast<unsigned long long>(value) > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+            {
+                return std::nullopt;
+            }
+        }
+        return static_cast<T>(value);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        if (type == libconfig::Setting::TypeFloat)
+        {
+            return static_cast<T>(static_cast<double>(setting));
+        }
+        if (type == libconfig::Setting::TypeInt)
+        {
+            return static_cast<T>(static_cast<int>(setting));
+        }
+        if (type == libconfig::Setting::TypeInt64)
+        {
+            return static_cast<T>(static_cast<long long>(setting));
+        }
+        return std::nullopt;
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        if (type == libconfig::Setting::TypeString)
+        {
+            return std::string(static_cast<const char*>(setting));
+        }
+        return std::nullopt;
+    }
+    else if constexpr (IsSettingVector<T>::value)
+    {
+        if (type != libconfig::Setting::TypeArray && type != libconfig::Setting::TypeList)
+        {
+            return std::nullopt;
+        }
+        T values;
+        values.reserve(setting.getLength());
+        for (int i = 0; i < setting.getLength(); ++i)
+        {
+            std::optional<typename T::value_type> element = convertSetting<typename T::value_type>(setting[i]);
+            if (!element)
+            {
+                return std::nullopt;
+            }
+            values.push_back(std::move(*element));
+        }
+        return values;
+    }
+    else
+    {
+        static_assert(UnsupportedSettingType<T>::value, "getSetting supports bool, integer, floating point, std::string and std::vector of these");
+    }
+}
+
+/*
+
+    Converts a value of a FlatConfig to a C++ type, with the same rules as convertSetting.
+*/
+
+template <typename T>
+std::optional<T> convertFlatValue(const FlatConfig& flat, const FlatValue& value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        if (value.type == FlatType::Boolean)
+        {
+            return value.boolValue;
+        }
+        return std::nullopt;
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        if (value.type != FlatType::Int && value.type != FlatType::Int64)
+        {
+            return std::nullopt;
+        }
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (value.intValue < static_cast<long long>(std::numeric_limits<T>::min()) || value.intValue > static_cast<long long>(std::numeric_limits<T>::max()))
+            {
+                return std::nullopt;
+            }
+        }
+        else
+        {
+            if (value.intValue < 0 || static_cast<unsigned long long>(value.intValue) > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+            {
+                return std::nullopt;
+            }
+        }
+        return static_cast<T>(value.intValue);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        if (value.type == FlatType::Float)
+        {
+            return static_cast<T>(value.floatValue);
+        }
+        if (value.type == FlatType::Int || value.type == FlatType::Int64)
+        {
+            return static_cast<T>(value.intValue);
+        }
+        return std::nullopt;
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        if (value.type == FlatType::String)
+        {
+            return std::string(flat.getString(value));
+        }
+        return std::nullopt;
+    }
+    else if constexpr (IsSettingVector<T>::value)
+    {
+        if (value.type != FlatType::Array && value.type != FlatType::List)
+        {
+            return std::nullopt;
+        }
+        const FlatValue* elements = flat.getElements(value);
+        T values;
+        values.reserve(value.elements.length);
+        for (uint32_t i = 0; i < value.elements.length; ++i)
+        {
+            std::optional<typename T::value_type> element = convertFlatValue<typename T::value_type>(flat, elements[i]);
+            if (!element)
+            {
+                return std::nullopt;
+            }
+            values.push_back(std::move(*element));
+        }
+        return values;
+    }
+    else
+    {
+        static_assert(UnsupportedSettingType<T>::value, "getSetting supports bool, integer, floating point, std::string and std::vector of these");
+    }
+}
+
+/*
+
+    Retrieves the value of a setting as a C++ type.
+
+    Example:
+        std::optional<double> period = getSetting<double>(cfg, "radiant.scalers.period");
+        std::optional<std::vector<float>> thresholds = getSetting<std::vector<float>>(cfg, "radiant.thresholds.initial");
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+    path :A string
+        The path to the setting.
+
+    Returns
+    -------
+    optional
+        The value of the setting, or no value if the setting does not exist or cannot be converted to T (see convertSetting).
+
+    Note:
+        Missing settings are not reported, so this function is suited to optional settings and scans over many runs.
+*/
+
+template <typename T>
+std::optional<T> getSetting(const libconfig::Config& config, const std::string& path)
+{
+    const libconfig::Setting* setting = findSetting(config.getRoot(), path);
+    if (!setting)
+    {
+        return std::nullopt;
+    }
+    return convertSetting<T>(*setting);
+}
+
+// Retrieves the value of a setting of a flattened configuration as a C++ type, see getSetting.
+template <typename T>
+std::optional<T> getSetting(const FlatConfig& flat, std::string_view path)
+{
+    const FlatSetting* setting = flat.find(path);
+    if (!setting)
+    {
+        return std::nullopt;
+    }
+    return convertFlatValue<T>(flat, setting->value);
+}
+
+/*
+
+    Retrieves the value of a common setting as a C++ type.
+
+    Parameters
+    ----------
+    config : Config
+        The configuration object that contains the settings.
+    alias :A string
+        The alias of the common setting, or a path to a setting.
+
+    Returns
+    -------
+    optional
+        The value of the setting, or no value if the alias is unknown, the setting does not exist or cannot be converted to T.
+*/
+
+template <typename T>
+std::optional<T> getCommonSetting(const libconfig::Config& config, const std::string& alias)
+{
+    if (alias.find(".") != std::string::npos)
+    {
+        return getSetting<T>(config, alias);
+    }
+    std::string_view path = resolveCommonSettingAlias(alias);
+    return !path.empty() ? getSetting<T>(config, std::string(path)) : std::nullopt;
+}
+
+// Retrieves the value of a common setting of a flattened configuration as a C++ type, see getCommonSetting.
+template <typename T>
+std::optional<T> getCommonSetting(const FlatConfig& flat, const std::string& alias)
+{
+    if (alias.find(".") != std::string::npos)
+    {
+        return getSetting<T>(flat, alias);
+    }
+    std::string_view path = resolveCommonSettingAlias(alias);
+    return !path.empty() ? getSetting<T>(flat, path) : std::nullopt;
+}
+
+/*
+
+    Builds the path to the configuration file of a run.
+
+    Parameters
+    ----------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    directory : string
+        The directory where the run data is stored.
+
+    Returns
+    -------
+    string
+        The path to the acq.cfg file of the run, relative to the directory.
+*/
+
+std::string getConfigFilepath(int station, int run, const std::string& directory);
+
+/*
+
+    Sets the base directory against which relative configuration paths are resolved.
+
+    Relative data directories passed to readConfigFile and the other readers are taken relative to this directory instead of the
+    current working directory, so that reading configurations never depends on or changes process-wide state. The default is the
+    root directory.
+
+    Parameters
+    ----------
+    baseDirectory : string
+        The base directory. An empty string restores the root directory.
+
+    Note:
+        The base directory can be changed at any time, also while other threads read configurations.
+*/
+
+std::mutex& getConfigBaseDirectoryMutex();
+
+std::shared_ptr<const std::string>& getConfigBaseDirectoryStorage();
+
+void setConfigBaseDirectory(const std::string& baseDirectory);
+
+// Returns the base directory set with setConfigBaseDirectory, always ending with a slash.
+std::string getConfigBaseDirectory();
+
+/*
+
+    Resolves a configuration path against the base directory.
+
+    Parameters
+    ----------
+    path : string
+        A path to a configuration file or data directory.
+
+    Returns
+    -------
+    string
+        The path itself if it is absolute, otherwise the path appended to the base directory.
+*/
+
+std::string resolveConfigPath(const std::string& path);
+
+/*
+
+    Parses a configuration file into a libconfig Config object.
+
+    Parameters
+    ----------
+    configFilepath : string
+        The path to the configuration file. A relative path is resolved against the base directory, see setConfigBaseDirectory.
+    cfg : Config
+        The configuration object to fill.
+
+    Returns
+    -------
+    bool
+        True if the file was read and parsed successfully, false otherwise.
+
+    Note:
+        I/O and parse errors are reported to the error log (see getConfigErrorLog) and through the return value.
+        The function does not change the working directory and is safe to call from several threads.
+        With a read limit set (see ConfigReadLimiter), the file is read with readFileContents and parsed from memory.
+*/
+
+bool parseConfigFile(const std::string& configFilepath, libconfig::Config& cfg);
+
+/*
+
+    Parses configuration text held in memory into a libconfig Config object.
+
+    This function allows parsing an acq.cfg that is already in memory, e.g. embedded in a rootified ROOT file or taken from the run
+    database, without going through the filesystem.
+
+    Parameters
+    ----------
+    data : const char*
+        The configuration text.
+    size : size_t
+        The length of the text in bytes. A terminating NUL byte may be included but is not required.
+    cfg : Config
+        The configuration object to fill.
+    source : string
+        A name for the text used in error messages, e.g. the file it came from.
+
+    Returns
+    -------
+    bool
+        True if the text was parsed successfully, false otherwise.
+
+    Note:
+        libconfig only parses NUL-terminated strings. Text that includes its terminating NUL byte is parsed in place, other text is
+        copied once.
+*/
+
+bool readConfigFromBuffer(const char* data, size_t size, libconfig::Config& cfg, const std::string& source = "buffer");
+
+/*
+
+    Parses a configuration file into a libconfig Config object through a memory mapping of the file.
+
+    Parameters
+    ----------
+    configFilepath : string
+        The path to the configuration file. A relative path is resolved against the base directory, as in parseConfigFile.
+    cfg : Config
+        The configuration object to fill.
+
+    Returns
+    -------
+    bool
+        True if the file was read and parsed successfully, false otherwise.
+
+    Note:
+        The mapping is parsed in place when the file does not fill its last page, since the rest of that page reads as zeros and
+        terminates the text. Otherwise the text is copied once.
+*/
+
+bool parseConfigFileMapped(const std::string& configFilepath, libconfig::Config& cfg);
+
+/*
+
+    Returns the modification time of a file with nanosecond resolution.
+*/
+
+timespec getModificationTime(const struct stat& fileStat);
+
+bool sameModificationTime(const timespec& a, const timespec& b);
+
+/*
+
+    Statistics of a ConfigCache.
+
+    Members
+    -------
+    hits : size_t
+        Number of lookups answered from the cache.
+    misses : size_t
+        Number of lookups that had to parse the configuration file.
+    invalidations : size_t
+        Number of cached configurations dropped because their file changed on disk.
+    evictions : size_t
+        Number of cached configurations dropped to stay below the memory cap.
+    entries : size_t
+        Number of configurations currently cached.
+    bytes : size_t
+        Estimated memory used by the cached configurations.
+*/
+
+struct ConfigCacheStats
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t invalidations = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+/*
+
+    LRU cache of parsed configuration files.
+
+    This class keeps parsed libconfig Config objects in memory, keyed by the path of the configuration file, so that repeated reads of the
+    same run do not parse its acq.cfg again. A cached configuration is only reused while the size and modification time of its file are
+    unchanged, otherwise the file is parsed again. The least recently used configurations are evicted once the estimated memory use goes
+    above the memory cap.
+
+    Note:
+        The cache is thread-safe. The configurations it hands out are shared and must not be modified.
+        The memory use of a parsed configuration is estimated from the size of its file, since libconfig does not report it.
+*/
+
+class ConfigCache
+{
+public:
+    explicit ConfigCache(size_t maxBytes = 256 * 1024 * 1024) : maxBytes_(maxBytes) {}
+
+    /*
+        Returns the parsed configuration file at path, parsing it if it is not cached or changed on disk.
+        Relative paths are resolved against the base directory, and the cache is keyed by the resolved path.
+        Returns a null pointer if the file could not be read or parsed.
+    */
+    std::shared_ptr<const libconfig::Config> get(const std::string& path);
+
+    // Sets the memory cap in bytes and evicts configurations until the cache fits in it.
+    void setMaxBytes(size_t maxBytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxBytes_ = maxBytes;
+        evictToFit();
+    }
+
+    size_t getMaxBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return maxBytes_;
+    }
+
+    // Drops the cached configuration of a file, e.g. after the file was removed. Relative paths are resolved like in get.
+    void invalidate(const std::string& path)
+    {
+        const std::string configFilepath = resolveConfigPath(path);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(configFilepath);
+        if (it != index_.end())
+        {
+            ++stats_.invalidations;
+            erase(it);
+        }
+    }
+
+    // Drops all cached configurations. The counters are kept.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lru_.clear();
+        index_.clear();
+        stats_.bytes = 0;
+        stats_.entries = 0;
+    }
+
+    ConfigCacheStats getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void resetStats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.hits = 0;
+        stats_.misses = 0;
+        stats_.invalidations = 0;
+        stats_.evictions = 0;
+    }
+
+private:
+    struct Entry
+    {
+        std::string path;
+        off_t size = 0;
+        timespec mtime = {};
+        size_t bytes = 0;
+        std::shared_ptr<const libconfig::Config> config;
+    };
+
+    typedef std::list<Entry>::iterator EntryIterator;
+
+    static size_t estimateBytes(off_t fileSize)
+    {
+        // libconfig allocates a node, a name and a value for every setting, which is a few times the size of its text
+        return sizeof(libconfig::Config) + 4 * static_cast<size_t>(fileSize);
+    }
+
+    void insert(Entry entry);
+
+    void erase(std::unordered_map<std::string, EntryIterator>::iterator it)
+    {
+        stats_.bytes -= it->second->bytes;
+        lru_.erase(it->second);
+        index_.erase(it);
+        stats_.entries = lru_.size();
+    }
+
+    void evictToFit()
+    {
+        while (stats_.bytes > maxBytes_ && !lru_.empty())
+        {
+            erase(index_.find(lru_.back().path));
+            ++stats_.evictions;
+        }
+    }
+
+    mutable std::mutex mutex_;
+    size_t maxBytes_;
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, EntryIterator> index_;
+    ConfigCacheStats stats_;
+};
+
+/*
+    Returns the process-wide configuration cache used by readConfigFile.
+*/
+
+ConfigCache& getConfigCache();
+
+/*
+    
+    Reads the configuration file for a run.
+
+    This function reads the configuration file for a run. 
+
+    Parameters
+    ----------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    directory : string
+        The directory where the run data is stored.
+    configSettingPath : string
+        The path to the common setting in the configuration file.
+
+    Returns
+    -------
+    string
+        The string representation of the setting value.
+
+    Note:
+        The function returns an empty string if the setting type is not supported.
+        The function only supports the following types of settings: integers, booleans, strings, arrays, and lists.
+        The function uses the settingValueToString function to convert the setting value to a string representation.
+        The parsed file is taken from the process-wide configuration cache, see getConfigCache.
+        A relative directory is resolved against the base directory (see setConfigBaseDirectory), so the function is safe to call
+        from several threads.
+*/
+
+void readConfigFile(int station, int run, const std::string& directory = "data/handcarry22/rootified", const std::string& configSettingPath = "radiant.scalers.use_pps");
+
+/*
+
+    Reads several settings from the configuration file for a run.
+
+    This function parses the configuration file of the run once and retrieves all the requested settings from it, instead of
+    reading the file again for every setting.
+
+    Parameters
+    ----------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    directory : string
+        The directory where the run data is stored.
+    configSettingPaths : vector of strings
+        The paths or common setting aliases to retrieve.
+
+    Returns
+    -------
+    unordered_map
+        A map from each requested path or alias to the string representation of its value.
+
+    Note:
+        The map is empty if the configuration file could not be read.
+        Settings that cannot be found are mapped to an empty string, as in getCommonSettingValue.
+        The parsed file is taken from the process-wide configuration cache, see getConfigCache.
+*/
+
+std::unordered_map<std::string, std::string> readConfigFile(int station, int run, const std::string& directory, const std::vector<std::string>& configSettingPaths);
+
+/*
+    Overload of the batch readConfigFile for brace-enclosed lists of paths, e.g. readConfigFile(23, 327, directory, {"rf0_enabled", "rf1_enabled"}).
+    Without it such calls would be ambiguous with the single setting version.
+*/
+
+std::unordered_map<std::string, std::string> readConfigFile(int station, int run, const std::string& directory, std::initializer_list<std::string> configSettingPaths);
+
+/*
+
+    Runs a task for every index in [0, count) on a pool of threads.
+
+    Every thread starts on its own contiguous block of indices, e.g. the runs of one or a few stations, and takes its tasks one at a
+    time from the front of the block. A thread that runs out of tasks steals the back half of the largest block left to another thread,
+    so stations with thousands of runs are shared out while neighbouring runs mostly stay on one thread.
+
+    Parameters
+    ----------
+    count : size_t
+        The number of tasks.
+    nThreads : unsigned int
+        The number of threads to use. Zero uses the number of hardware threads.
+    task : function
+        The task to run, called with the index of the task.
+
+    Note:
+        The order in which tasks run is not deterministic, callers store results by index to return them in order.
+*/
+
+void parallelFor(size_t count, unsigned int nThreads, const std::function<void(size_t)>& task);
+
+/*
+
+    Limit on the number of configuration files read at the same time, separate from the number of threads parsing them.
+
+    Every read of a configuration file, by parseConfigFile and readFileContents and so by the cache, snapshots, change streams, stores
+    and location indexes, is made under this limit, and the parse runs after releasing it. A bulk load on nThreads threads thus has at
+    most the limit of reads in flight while the other threads parse. A small limit avoids seeking around a local disk or flooding a
+    file server, and a bulk load over a high-latency network filesystem can use more threads than cores with a larger limit.
+
+    Example:
+        getConfigReadLimiter().setLimit(4);
+        scanConfigFiles("data/handcarry22/rootified", {"radiant.scalers.period"}, 16);
+*/
+
+class ConfigReadLimiter
+{
+public:
+    // Sets the maximum number of concurrent reads. Zero, the default, leaves reads unlimited and lets libconfig read the files.
+    void setLimit(unsigned int limit)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit_ = limit;
+        available_.notify_all();
+    }
+
+    unsigned int getLimit() const
+    {
+        return limit_.load(std::memory_order_relaxed);
+    }
+
+    // Waits until a read may start. Returns false without waiting if reads are unlimited, such reads must not call release.
+    bool acquire()
+    {
+        if (limit_.load(std::memory_order_relaxed) == 0)
+        {
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        available_.wait(lock, [this]() { return limit_ == 0 || active_ < limit_; });
+        if (limit_ == 0)
+        {
+            return false;
+        }
+        ++active_;
+        return true;
+    }
+
+    // Ends a read for which acquire returned true.
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --active_;
+        available_.notify_one();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::atomic<unsigned int> limit_{0};
+    unsigned int active_ = 0;
+};
+
+ConfigReadLimiter& getConfigReadLimiter();
+
+// Holds a read of the process-wide read limiter for its lifetime.
+class ConfigReadGuard
+{
+public:
+    ConfigReadGuard() : acquired_(getConfigReadLimiter().acquire()) {}
+    ConfigReadGuard(const ConfigReadGuard&) = delete;
+    ConfigReadGuard& operator=(const ConfigReadGuard&) = delete;
+
+    ~ConfigReadGuard()
+    {
+        if (acquired_)
+        {
+            getConfigReadLimiter().release();
+        }
+    }
+
+private:
+    const bool acquired_;
+};
+
+/*
+
+    Parses the number at the end of a directory name such as "station23" or "run327".
+
+    Parameters
+    ----------
+    name : string
+        The directory name.
+    prefix : string
+        The expected prefix of the name.
+    number : int
+        Set to the parsed number.
+
+    Returns
+    -------
+    bool
+        True if the name is the prefix followed by a number only.
+
+    Note:
+        Numbers with leading zeros, such as "run0327", and numbers that do not fit an int are rejected. The paths of a run are built
+        from its numbers (see getConfigFilepath), so such a directory would be listed under a path that does not exist.
+*/
+
+bool parseNumberedName(const std::string& name, const std::string& prefix, int& number);
+
+/*
+
+    Lists the entries of a directory whose names are a prefix followed by a number, sorted by that number.
+
+    Note:
+        A directory that cannot be opened, e.g. a data directory that does not exist, is reported to the error log and gives no entries.
+*/
+
+std::vector<std::pair<int, std::string>> listNumberedDirectories(const std::string& directory, const std::string& prefix);
+
+/*
+
+    A station and run whose configuration file was found by findConfigRuns.
+*/
+
+struct ConfigRun
+{
+    int station;
+    int run;
+};
+
+/*
+
+    Finds the runs that have a configuration file.
+
+    This function enumerates the station<N>/run<M>/cfg/acq.cfg tree below the directory.
+
+    Parameters
+    ----------
+    directory : string
+        The directory where the run data is stored.
+
+    Returns
+    -------
+    vector of ConfigRun
+        The station and run numbers of every configuration file found, sorted by station and run.
+
+    Note:
+        As in readConfigFile, a relative directory is resolved against the base directory, see setConfigBaseDirectory.
+*/
+
+std::vector<ConfigRun> findConfigRuns(const std::string& directory = "data/handcarry22/rootified");
+
+/*
+
+    The settings read from the configuration file of one run by scanConfigFiles.
+
+    Members
+    -------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    parsed : bool
+        False if the configuration file could not be read or parsed.
+    values : vector of strings
+        The string representation of each requested setting, in the order of the requested paths.
+*/
+
+struct RunConfigValues
+{
+    int station = 0;
+    int run = 0;
+    bool parsed = false;
+    std::vector<std::string> values;
+};
+
+/*
+
+    Reads settings from the configuration files of many runs in parallel.
+
+    Parameters
+    ----------
+    directory : string
+        The directory where the run data is stored.
+    runs : vector of ConfigRun
+        The runs to read, e.g. from findConfigRuns.
+    configSettingPaths : vector of strings
+        The paths or common setting aliases to retrieve.
+    nThreads : unsigned int
+        The number of threads reading files. Reading over network storage is limited by latency rather than CPU, so
+        more threads than cores usually helps.
+
+    Returns
+    -------
+    vector of RunConfigValues
+        The settings of each run, in the order of the runs.
+*/
+
+std::vector<RunConfigValues> scanConfigFiles(const std::string& directory, const std::vector<ConfigRun>& runs, const std::vector<std::string>& configSettingPaths, unsigned int nThreads = 16);
+
+/*
+
+    Reads settings from every configuration file of a season in parallel.
+
+    This function enumerates the station<N>/run<M>/cfg/acq.cfg tree with findConfigRuns and reads the settings with scanConfigFiles.
+*/
+
+std::vector<RunConfigValues> scanConfigFiles(const std::string& directory, const std::vector<std::string>& configSettingPaths, unsigned int nThreads = 16);
+
+/*
+
+    Prints the results of scanConfigFiles as a tab separated station x run x setting table.
+
+    Parameters
+    ----------
+    results : vector of RunConfigValues
+        The scan results.
+    configSettingPaths : vector of strings
+        The paths or aliases that were scanned, used as column headers.
+    out : ostream
+        The stream to print to.
+
+    Note:
+        Runs whose configuration file could not be parsed are printed with empty values.
+        Newlines in values (e.g. whole groups) are replaced by spaces to keep one line per run.
+*/
+
+void printConfigTable(const std::vector<RunConfigValues>& results, const std::vector<std::string>& configSettingPaths, std::ostream& out = std::cout);
+
+/*
+
+    Reads the configuration files of an ordered list of runs ahead of their use.
+
+    Analyses that process runs in order would otherwise stall at every new run while its acq.cfg is read and parsed. A ConfigPrefetcher
+    parses the next runs of the list on a background thread and keeps up to depth of them ready in a bounded queue, so get() usually
+    returns without touching the file system. The configurations are taken from the process-wide configuration cache, see getConfigCache,
+    so readConfigFile calls for a prefetched run are answered from memory as well.
+
+    Example:
+        ConfigPrefetcher prefetcher("data/handcarry22/rootified", findConfigRuns());
+        for (each event) { std::shared_ptr<const libconfig::Config> cfg = prefetcher.get(station, run); ... }
+
+    Note:
+        get() is meant to be called from one analysis thread. Asking for a run that is not next in the list skips the runs before it;
+        a run that is not in the list, or was already skipped, is read directly.
+*/
+
+class ConfigPrefetcher
+{
+public:
+    ConfigPrefetcher(const std::string& directory, std::vector<ConfigRun> runs, size_t depth = 4)
+        : directory_(directory), runs_(std::move(runs)), depth_(std::max<size_t>(1, depth))
+    {
+        positions_.reserve(runs_.size());
+        for (size_t i = 0; i < runs_.size(); ++i)
+        {
+            positions_.emplace(key(runs_[i].station, runs_[i].run), i);
+        }
+        worker_ = std::thread(&ConfigPrefetcher::prefetch, this);
+    }
+
+    ConfigPrefetcher(const ConfigPrefetcher&) = delete;
+    ConfigPrefetcher& operator=(const ConfigPrefetcher&) = delete;
+
+    ~ConfigPrefetcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        spaceAvailable_.notify_all();
+        worker_.join();
+    }
+
+    /*
+        Returns the parsed configuration file of a run, waiting for the background thread if it is still being read.
+        Returns a null pointer if the file could not be read or parsed.
+    */
+    std::shared_ptr<const libconfig::Config> get(int station, int run);
+
+    // Returns the runs the prefetcher reads, in order.
+    const std::vector<ConfigRun>& getRuns() const
+    {
+        return runs_;
+    }
+
+private:
+    static uint64_t key(int station, int run)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(station)) << 32) | static_cast<uint32_t>(run);
+    }
+
+    // Body of the background thread: parses the runs in order, staying at most depth_ runs ahead of the consumer.
+    void prefetch();
+
+    const std::string directory_;
+    const std::vector<ConfigRun> runs_;
+    const size_t depth_;
+    std::unordered_map<uint64_t, size_t> positions_;
+
+    std::mutex mutex_;
+    std::condition_variable spaceAvailable_;
+    std::condition_variable configReady_;
+    std::deque<std::pair<size_t, std::shared_ptr<const libconfig::Config>>> ready_;
+    size_t consumed_ = 0;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+/*
+
+    Layout of a configuration snapshot file.
+
+    A snapshot starts with a SnapshotHeader, followed by one SnapshotRunRecord per run sorted by station and run, the tables of every
+    run and finally a string pool shared by all runs, in which every path and string value is stored once. The tables of a run are the
+    FlatSetting, sorted index and FlatValue element tables of its FlatConfig, with string offsets pointing into the shared pool, so a
+    mapped snapshot is read through FlatConfig without any parsing. All offsets are in bytes from the start of the file and 8-byte
+    aligned. Numbers are stored in the byte order of the machine that wrote the snapshot, which is checked when it is opened.
+*/
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t runCount;
+    uint64_t runsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct SnapshotRunRecord
+{
+    int32_t station;
+    int32_t run;
+    int64_t mtimeSeconds;
+    int64_t mtimeNanoseconds;
+    uint64_t fileSize;
+    uint64_t settingsOffset;
+    uint64_t sortedOffset;
+    uint64_t elementsOffset;
+    uint32_t settingsCount;
+    uint32_t elementsCount;
+};
+
+static_assert(sizeof(SnapshotHeader) == 48 && sizeof(SnapshotRunRecord) == 64, "snapshot records must keep their layout");
+
+constexpr char snapshotMagic[8] = {'R', 'N', 'O', 'G', 'C', 'F', 'G', 'S'};
+constexpr uint32_t snapshotVersion = 1;
+constexpr uint32_t snapshotByteOrder = 0x01020304;
+
+/*
+
+    The configuration of one run in a snapshot.
+
+    Members
+    -------
+    station, run : int
+        The station and run numbers.
+    mtime : timespec
+        The modification time of the acq.cfg the configuration was read from.
+    fileSize : uint64_t
+        The size of the acq.cfg the configuration was read from.
+    config : FlatConfig
+        The flattened configuration.
+*/
+
+struct SnapshotRun
+{
+    int station = 0;
+    int run = 0;
+    timespec mtime = {};
+    uint64_t fileSize = 0;
+    FlatConfig config;
+};
+
+/*
+
+    A read-only memory mapping of a whole file, unmapped when destroyed.
+*/
+
+class MappedFile
+{
+public:
+    MappedFile(const void* data, size_t size) : data_(data), size_(size) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        munmap(const_cast<void*>(data_), size_);
+    }
+
+    const char* getData() const
+    {
+        return static_cast<const char*>(data_);
+    }
+
+    size_t getSize() const
+    {
+        return size_;
+    }
+
+    // Maps the file at path, returning a null pointer if it cannot be opened or is empty.
+    static std::shared_ptr<const MappedFile> open(const std::string& path);
+
+private:
+    const void* data_;
+    size_t size_;
+};
+
+/*
+
+    A configuration snapshot mapped into memory.
+
+    This class gives access to the configurations of all runs stored in a snapshot file written by writeConfigSnapshot or
+    updateConfigSnapshot. The configurations are FlatConfig views of the mapped file, so the usual reader functions work on them
+    directly, e.g.
+        ConfigSnapshot snapshot;
+        snapshot.open("season.snapshot");
+        std::string period = getCommonSettingValue(*snapshot.getConfig(23, 327), "scalers_period");
+
+    Note:
+        All offsets of the file are checked when it is opened, so a corrupt snapshot is rejected rather than read out of bounds.
+        The FlatConfig objects of a snapshot keep the mapping alive, also after the ConfigSnapshot is destroyed.
+*/
+
+class ConfigSnapshot
+{
+public:
+    /*
+        Opens a snapshot file. Returns false and reports an error if it cannot be read or is not a valid snapshot.
+    */
+    bool open(const std::string& snapshotPath);
+
+    // Returns the run of the snapshot, or a null pointer if the snapshot does not contain it.
+    const SnapshotRun* find(int station, int run) const;
+
+    // Returns the configuration of a run, or a null pointer if the snapshot does not contain it.
+    const FlatConfig* getConfig(int station, int run) const
+    {
+        const SnapshotRun* snapshotRun = find(station, run);
+        return snapshotRun ? &snapshotRun->config : nullptr;
+    }
+
+    // Returns all runs of the snapshot, sorted by station and run.
+    const std::vector<SnapshotRun>& getRuns() const
+    {
+        return runs_;
+    }
+
+private:
+    template <typename T>
+    static bool inBounds(uint64_t offset, uint64_t count, size_t size)
+    {
+        return offset % alignof(T) == 0 && offset <= size && count <= (size - offset) / sizeof(T);
+    }
+
+    static bool validRange(const FlatValue::Range& range, uint64_t size)
+    {
+        return range.offset <= size && range.length <= size - range.offset;
+    }
+
+    bool load(const std::shared_ptr<const MappedFile>& mapping);
+
+    static bool validValue(const FlatValue& value, uint64_t stringsSize, uint64_t elementsCount);
+
+    std::vector<SnapshotRun> runs_;
+};
+
+/*
+
+    The tables of several flattened configurations, remapped onto one pool of strings.
+
+    Members
+    -------
+    strings : string
+        The pool, in which every path and string value is stored once.
+    settings, elements : vector of vectors
+        The FlatSetting and FlatValue element tables of every configuration, with string offsets pointing into the pool.
+*/
+
+struct InternedFlatTables
+{
+    std::string strings;
+    std::vector<std::vector<FlatSetting>> settings;
+    std::vector<std::vector<FlatValue>> elements;
+};
+
+/*
+    Interns the paths and string values of the configurations of many runs into one pool. Runs of a season share nearly all their
+    paths and most of their strings, so the pool is little larger than the strings of a single run.
+*/
+
+InternedFlatTables internFlatConfigs(const std::vector<SnapshotRun>& runs);
+
+/*
+
+    Writes the configurations of many runs to a snapshot file.
+
+    Parameters
+    ----------
+    snapshotPath : string
+        The path of the snapshot file. A relative path is resolved against the base directory.
+    runs : vector of SnapshotRun
+        The runs to store. They are stored sorted by station and run; if a run is given twice the first one is kept.
+
+    Returns
+    -------
+    bool
+        True if the snapshot was written, false otherwise.
+
+    Note:
+        The snapshot is written to a temporary file that then replaces the snapshot, so readers never see a partial snapshot and the
+        runs may be views of the snapshot being replaced.
+*/
+
+bool writeConfigSnapshot(const std::string& snapshotPath, std::vector<SnapshotRun> runs);
+
+/*
+
+    Builds or incrementally updates the snapshot of a season.
+
+    This function enumerates the station<N>/run<M>/cfg/acq.cfg tree like findConfigRuns and writes a snapshot of all runs found. Runs
+    already in an existing snapshot whose acq.cfg has the same size and modification time are copied from it without parsing, so only
+    new and changed runs are parsed.
+
+    Parameters
+    ----------
+    snapshotPath : string
+        The path of the snapshot file to create or update.
+    directory : string
+        The directory where the run data is stored.
+    nThreads : unsigned int
+        The number of threads parsing new runs.
+
+    Returns
+    -------
+    int
+        The number of runs parsed, or -1 if the snapshot could not be written.
+
+    Note:
+        Runs that no longer exist in the directory are dropped from the snapshot. Runs that fail to parse are left out.
+*/
+
+int updateConfigSnapshot(const std::string& snapshotPath, const std::string& directory = "data/handcarry22/rootified", unsigned int nThreads = 16);
+
+/*
+
+    A channel-indexed array setting extracted for many runs, stored as one contiguous block.
+
+    Members
+    -------
+    runs : vector of ConfigRun
+        The runs, one row each.
+    width : size_t
+        The number of values per run, usually the number of channels.
+    values : vector
+        The values, row-major: the values of run i are values[i * width] to values[(i + 1) * width - 1]. Runs without the setting and
+        arrays shorter than width are padded with the fill value.
+    found : vector of uint8_t
+        1 for the runs whose setting was found and converted, 0 otherwise.
+*/
+
+template <typename T>
+struct ConfigColumn
+{
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "ConfigColumn holds integer or floating point values");
+
+    std::vector<ConfigRun> runs;
+    size_t width = 0;
+    std::vector<T> values;
+    std::vector<uint8_t> found;
+
+    // Returns the values of run i.
+    const T* getRow(size_t i) const
+    {
+        return values.data() + i * width;
+    }
+};
+
+// Returns the value used to pad ConfigColumn rows: NaN for floating point types and 0 for integer types.
+template <typename T>
+constexpr T defaultColumnFill()
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    else
+    {
+        return T(0);
+    }
+}
+
+/*
+
+    Copies the elements of an array or list of a FlatConfig to a buffer, with the conversion rules of convertSetting.
+
+    Parameters
+    ----------
+    flat : FlatConfig
+        The flattened configuration holding the value.
+    value : FlatValue
+        The array or list.
+    out : pointer
+        The buffer, of at least width values.
+    width : size_t
+        The number of values to write. Elements beyond width are dropped and missing elements are set to fill.
+    fill : T
+        The value of missing elements.
+
+    Returns
+    -------
+    bool
+        True if the value is an array or list and all its copied elements converted to T. The buffer is then filled, otherwise its
+        contents are unspecified.
+*/
+
+template <typename T>
+bool copyArrayValues(const FlatConfig& flat, const FlatValue& value, T* out, size_t width, T fill = defaultColumnFill<T>())
+{
+    if (value.type != FlatType::Array && value.type != FlatType::List)
+    {
+        return false;
+    }
+    const FlatValue* elements = flat.getElements(value);
+    const size_t count = std::min<size_t>(value.elements.length, width);
+    bool converted = true;
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        // Arrays are homogeneous, so the common case of float arrays is one branch-free loop over the elements.
+        if (value.type == FlatType::Array && count > 0 && elements[0].type == FlatType::Float)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = static_cast<T>(elements[i].floatValue);
+            }
+            std::fill(out + count, out + width, fill);
+            return true;
+        }
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::optional<T> element = convertFlatValue<T>(flat, elements[i]);
+        converted &= element.has_value();
+        out[i] = element.value_or(fill);
+    }
+    std::fill(out + count, out + width, fill);
+    return converted;
+}
+
+/*
+
+    Copies the elements of a libconfig array or list to a buffer, see copyArrayValues for FlatConfig.
+*/
+
+template <typename T>
+bool copyArrayValues(const libconfig::Setting& setting, T* out, size_t width, T fill = defaultColumnFill<T>())
+{
+    if (!setting.isArray() && !setting.isList())
+    {
+        return false;
+    }
+    const size_t count = std::min<size_t>(setting.getLength(), width);
+    bool converted = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::optional<T> element = convertSetting<T>(setting[static_cast<int>(i)]);
+        converted &= element.has_value();
+        out[i] = element.value_or(fill);
+    }
+    std::fill(out + count, out + width, fill);
+    return converted;
+}
+
+// Resolves a common setting alias or path for the column extractors, reporting unknown aliases to the error log.
+std::string resolveColumnPath(const std::string& alias);
+
+/*
+
+    Extracts an array setting of many runs into a contiguous block, ready for RDataFrame or numpy.
+
+    The configuration files are read in parallel through the process-wide configuration cache, and every thread converts the array of
+    its run straight into that run's row of the block, without formatting any value as a string.
+
+    Example:
+        ConfigColumn<float> thresholds = extractConfigColumn<float>("data/handcarry22/rootified", findConfigRuns(), "radiant.thresholds.initial");
+        ROOT::RVecF channels(const_cast<float*>(thresholds.getRow(i)), thresholds.width);   // a view of run i, without copying
+
+    Parameters
+    ----------
+    directory : string
+        The directory where the run data is stored.
+    runs : vector of ConfigRun
+        The runs to read, e.g. from findConfigRuns.
+    alias : string
+        The common setting alias or path of the array.
+    width : size_t
+        The number of values per run, 24 channels by default.
+    nThreads : unsigned int
+        The number of threads reading configuration files.
+
+    Returns
+    -------
+    ConfigColumn
+        The values of every run, with found set to 0 for runs without the setting, or whose file could not be read.
+*/
+
+template <typename T>
+ConfigColumn<T> extractConfigColumn(const std::string& directory, const std::vector<ConfigRun>& runs, const std::string& alias, size_t width = 24, unsigned int nThreads = 16)
+{
+    ConfigColumn<T> column;
+    column.runs = runs;
+    column.width = width;
+    column.values.assign(runs.size() * width, defaultColumnFill<T>());
+    column.found.assign(runs.size(), 0);
+    const std::string path = resolveColumnPath(alias);
+    if (path.empty())
+    {
+        return column;
+    }
+
+    parallelFor(runs.size(), nThreads, [&](size_t i)
+    {
+        std::shared_ptr<const libconfig::Config> cfg = getConfigCache().get(getConfigFilepath(runs[i].station, runs[i].run, directory));
+        const libconfig::Setting* setting = cfg ? findSetting(cfg->getRoot(), path) : nullptr;
+        if (!setting)
+        {
+            return;
+        }
+        T* row = column.values.data() + i * width;
+        if (copyArrayValues<T>(*setting, row, width))
+        {
+            column.found[i] = 1;
+        }
+        else
+        {
+            std::fill(row, row + width, defaultColumnFill<T>());
+        }
+    });
+    return column;
+}
+
+/*
+
+    Extracts an array setting of all runs of a configuration snapshot into a contiguous block, see extractConfigColumn.
+    The snapshot is already flattened, so the whole extraction is a copy out of the mapped element tables.
+*/
+
+template <typename T>
+ConfigColumn<T> extractConfigColumn(const ConfigSnapshot& snapshot, const std::string& alias, size_t width = 24)
+{
+    const std::vector<SnapshotRun>& snapshotRuns = snapshot.getRuns();
+    ConfigColumn<T> column;
+    column.runs.reserve(snapshotRuns.size());
+    for (const SnapshotRun& run : snapshotRuns)
+    {
+        column.runs.push_back({run.station, run.run});
+    }
+    column.width = width;
+    column.values.assign(snapshotRuns.size() * width, defaultColumnFill<T>());
+    column.found.assign(snapshotRuns.size(), 0);
+    const std::string path = resolveColumnPath(alias);
+    if (path.empty())
+    {
+        return column;
+    }
+
+    for (size_t i = 0; i < snapshotRuns.size(); ++i)
+    {
+        const FlatConfig& flat = snapshotRuns[i].config;
+        const FlatSetting* setting = flat.find(path);
+        if (!setting)
+        {
+            continue;
+        }
+        T* row = column.values.data() + i * width;
+        if (copyArrayValues<T>(flat, setting->value, row, width))
+        {
+            column.found[i] = 1;
+        }
+        else
+        {
+            std::fill(row, row + width, defaultColumnFill<T>());
+        }
+    }
+    return column;
+}
+
+/*
+
+    Computes the 64-bit FNV-1a hash of the contents of a configuration file.
+*/
+
+uint64_t hashConfigContent(const char* data, size_t size);
+
+/*
+
+    Reads a whole file into a string.
+
+    Parameters
+    ----------
+    path : string
+        The path to the file. A relative path is resolved against the base directory.
+    contents : string
+        Set to the contents of the file.
+
+    Returns
+    -------
+    bool
+        True if the file was read, false otherwise.
+
+    Note:
+        The read counts against the read limit, see ConfigReadLimiter.
+*/
+
+bool readFileContents(const std::string& path, std::string& contents);
+
+/*
+
+    A setting found in a ConfigStore, together with the configuration it belongs to.
+*/
+
+struct ConfigStoreValue
+{
+    const FlatConfig* config = nullptr;
+    const FlatSetting* setting = nullptr;
+
+    explicit operator bool() const
+    {
+        return setting != nullptr;
+    }
+};
+
+/*
+
+    Statistics of a ConfigStore.
+
+    Members
+    -------
+    runs : size_t
+        Number of runs added.
+    contents : size_t
+        Number of distinct file contents in use, each stored once.
+    fullConfigs : size_t
+        Number of distinct contents stored as a complete FlatConfig.
+    deltaConfigs : size_t
+        Number of distinct contents stored as a base configuration plus the settings that differ from it.
+*/
+
+struct ConfigStoreStats
+{
+    size_t runs = 0;
+    size_t contents = 0;
+    size_t fullConfigs = 0;
+    size_t deltaConfigs = 0;
+};
+
+/*
+
+    Deduplicated in-memory storage of the configurations of many runs.
+
+    Consecutive runs of a station usually have identical or nearly identical acq.cfg files. This class stores runs with identical file
+    contents (by content hash) as one shared configuration. A configuration that has the same settings as an already stored base
+    configuration but differs in a few values is stored as that base plus the differing settings only. For every run the paths that
+    changed with respect to the previous run of the station are kept as well, so runsWhereSettingChanged answers without touching any
+    file.
+
+    Note:
+        A delta is only used when the set of paths is unchanged and at most maxDeltaFraction of the settings differ from the base,
+        otherwise the configuration is stored complete and becomes the base of later runs.
+        Contents are looked up by their 64-bit hash and shared only if their text is the same, so the text of every distinct content is
+        kept with it. A content is dropped once no run refers to it any more, e.g. when its runs were added again with new contents.
+        The store is not thread-safe.
+*/
+
+class ConfigStore
+{
+public:
+    explicit ConfigStore(double maxDeltaFraction = 0.1) : maxDeltaFraction_(maxDeltaFraction) {}
+
+    /*
+        Adds the configuration of a run from the text of its acq.cfg. Returns false if the text cannot be parsed.
+        Adding a run again replaces it.
+    */
+    bool add(int station, int run, const char* data, size_t size);
+
+    // Adds the configuration of a run from its acq.cfg in the directory. Returns false if it cannot be read or parsed.
+    bool addFile(int station, int run, const std::string& directory = "data/handcarry22/rootified")
+    {
+        std::string contents;
+        if (!readFileContents(getConfigFilepath(station, run, directory), contents))
+        {
+            getConfigErrorLog().report(ConfigStatus::IOError, getConfigFilepath(station, run, directory));
+            return false;
+        }
+        return add(station, run, contents.data(), contents.size());
+    }
+
+    bool contains(int station, int run) const
+    {
+        return runs_.count(Key(station, run)) != 0;
+    }
+
+    /*
+        Finds a setting of a run. For runs stored as a delta the setting comes from the delta if it changed and from the base
+        otherwise. Groups are found with their base children; use getConfig to read the whole group of a delta run.
+    */
+    ConfigStoreValue find(int station, int run, std::string_view path) const;
+
+    /*
+        Returns the complete configuration of a run, or an empty FlatConfig if the run is not in the store. Configurations stored as
+        a delta are rebuilt from their base.
+    */
+    FlatConfig getConfig(int station, int run) const;
+
+    /*
+        Returns the runs in which a setting changed with respect to the previous run of the same station, sorted by station and run.
+        A path of a group matches changes of any setting in the group. The first run of each station is never included.
+    */
+    std::vector<ConfigRun> runsWhereSettingChanged(std::string_view path) const;
+
+    ConfigStoreStats getStats() const
+    {
+        ConfigStoreStats stats;
+        stats.runs = runs_.size();
+        stats.contents = contents_.size();
+        for (const auto& content : contents_)
+        {
+            ++(content.second.stored->deltaIndices.empty() ? stats.fullConfigs : stats.deltaConfigs);
+        }
+        return stats;
+    }
+
+private:
+    typedef std::pair<int, int> Key;
+
+    struct StoredConfig
+    {
+        std::string text;
+        FlatConfig base;
+        FlatConfig delta;
+        std::vector<uint32_t> deltaIndices;
+    };
+
+    struct StoredRun
+    {
+        uint64_t hash = 0;
+        std::shared_ptr<const StoredConfig> stored;
+        std::vector<SettingPathId> changedPaths;
+    };
+
+    // A distinct content and the number of runs referring to it.
+    struct StoredContent
+    {
+        std::shared_ptr<const StoredConfig> stored;
+        size_t runs;
+    };
+
+    // Stores a new configuration as a delta on the base of a neighbouring run of the station if it is close enough, or complete.
+    std::shared_ptr<const StoredConfig> store(FlatConfig config, std::string_view text, int station, int run);
+
+    // Drops the reference of a run to its content, and the content if no other run refers to it.
+    void release(const StoredRun& run);
+
+    // Checks that two configurations have the same paths in the same order and lists the indices of the settings with other values.
+    static bool sameStructure(const FlatConfig& base, const FlatConfig& config, std::vector<uint32_t>& changed);
+
+    // Recomputes the paths of a run that changed with respect to the previous run of its station.
+    void updateChangedPaths(std::map<Key, StoredRun>::iterator it);
+
+    double maxDeltaFraction_;
+    std::map<Key, StoredRun> runs_;
+    std::unordered_multimap<uint64_t, StoredContent> contents_;
+};
+
+/*
+
+    Kind of a change between the configurations of two runs.
+*/
+
+enum class ConfigChangeKind
+{
+    Added,
+    Removed,
+    Modified
+};
+
+/*
+
+    A setting that changed between the configurations of two consecutive runs of a station.
+
+    Members
+    -------
+    station : int
+        The station number.
+    previousRun, run : int
+        The run before the change and the run with the change.
+    kind : ConfigChangeKind
+        Whether the setting was added, removed or modified in run.
+    path : string
+        The path to the setting.
+    oldValue, newValue : string
+        The string representations of the setting in previousRun and run, empty if it does not exist in that run.
+*/
+
+struct ConfigChange
+{
+    int station = 0;
+    int previousRun = 0;
+    int run = 0;
+    ConfigChangeKind kind = ConfigChangeKind::Modified;
+    std::string path;
+    std::string oldValue;
+    std::string newValue;
+};
+
+/*
+
+    Checks whether a path is one of a set of paths or inside one of them (for groups). An empty set matches every path.
+*/
+
+bool pathMatches(std::string_view path, const std::vector<std::string>& filters);
+
+/*
+
+    Reports the settings that differ between two flattened configurations as ConfigChange records.
+
+    Parameters
+    ----------
+    before, after : FlatConfig
+        The configurations to compare.
+    paths : vector of strings
+        The paths, group paths or common setting aliases to report. Empty reports every change.
+    changed : function
+        Called with every ConfigChange. The station and run numbers of the records are left to the caller.
+*/
+
+void diffConfigs(const FlatConfig& before, const FlatConfig& after, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed);
+
+// Reports the settings that differ between two parsed configurations, see diffConfigs for FlatConfig.
+void diffConfigs(const libconfig::Config& before, const libconfig::Config& after, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed);
+
+/*
+
+    Streams the configuration changes between consecutive runs.
+
+    This function reads the runs in order and compares each one with the previous run of the same station, keeping only the flattened
+    configuration of the previous run in memory, so a whole season can be diffed in one pass.
+
+    Parameters
+    ----------
+    directory : string
+        The directory where the run data is stored.
+    runs : vector of ConfigRun
+        The runs to compare, e.g. from findConfigRuns. They are sorted by station and run first.
+    paths : vector of strings
+        The paths, group paths or common setting aliases to report. Empty reports every change.
+    changed : function
+        Called with every change, in station, run and path order.
+
+    Note:
+        Runs whose configuration file cannot be read are skipped, the next run is then compared with the last run that was read.
+*/
+
+void streamConfigChanges(const std::string& directory, std::vector<ConfigRun> runs, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed);
+
+// Streams the configuration changes between consecutive runs firstRun to lastRun of a station, see streamConfigChanges.
+void streamConfigChanges(int station, int firstRun, int lastRun, const std::string& directory, const std::vector<std::string>& paths, const std::function<void(const ConfigChange&)>& changed);
+
+/*
+
+    The location and state of the configuration file of one run, as recorded by ConfigLocationIndex.
+
+    Members
+    -------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    path : string
+        The path of the configuration file.
+    size : uint64_t
+        The size of the file in bytes.
+    mtime : timespec
+        The modification time of the file.
+    hash : uint64_t
+        The hash of the contents of the file, see hashConfigContent.
+*/
+
+struct ConfigLocation
+{
+    int station = 0;
+    int run = 0;
+    std::string path;
+    uint64_t size = 0;
+    timespec mtime = {};
+    uint64_t hash = 0;
+};
+
+/*
+
+    Persistent index of the configuration files of a season.
+
+    The index records where the configuration file of every run is, with its size, modification time and content hash, so a job can
+    enumerate the runs and tell missing runs apart without walking the directory tree or touching the files. It is built by one scan
+    with update() and saved to a small text file. Later updates only list the station directories whose modification time changed,
+    i.e. that gained or lost runs, and only hash files whose size or modification time changed. Run directories that had no
+    configuration file yet, as when the DAQ has created the run but not written its acq.cfg, are remembered and stat'd again on every
+    update, so their file is found as soon as it is written.
+
+    Example:
+        ConfigLocationIndex index;
+        index.load("data/handcarry22/rootified/configs.index");
+        index.update("data/handcarry22/rootified");
+        index.save("data/handcarry22/rootified/configs.index");
+        if (const ConfigLocation* location = index.find(23, 327)) { ... location->path ... }
+
+    Note:
+        A configuration file replaced in an existing run directory does not change the modification time of its station directory. Such
+        changes to indexed runs are found by updates with verifyFiles, which stat every indexed file but still only list the changed
+        stations.
+*/
+
+class ConfigLocationIndex
+{
+public:
+    // Returns the location of a run, or a null pointer if the index does not contain it.
+    const ConfigLocation* find(int station, int run) const;
+
+    bool contains(int station, int run) const
+    {
+        return find(station, run) != nullptr;
+    }
+
+    // Returns the locations of all runs, sorted by station and run.
+    const std::vector<ConfigLocation>& getLocations() const
+    {
+        return locations_;
+    }
+
+    // Returns the station and run numbers of all runs, sorted by station and run.
+    std::vector<ConfigRun> getRuns() const
+    {
+        std::vector<ConfigRun> runs;
+        runs.reserve(locations_.size());
+        for (const ConfigLocation& location : locations_)
+        {
+            runs.push_back({location.station, location.run});
+        }
+        return runs;
+    }
+
+    // Returns the directory the index was last updated from.
+    const std::string& getDirectory() const
+    {
+        return directory_;
+    }
+
+    /*
+
+        Updates the index from the station<N>/run<M>/cfg/acq.cfg tree below a directory.
+
+        Parameters
+        ----------
+        directory : string
+            The directory where the run data is stored. Updating from another directory than the last one rebuilds the index.
+        verifyFiles : bool
+            Also stat the indexed files of unchanged stations, to find configuration files replaced in place.
+        nThreads : unsigned int
+            The number of threads reading files.
+
+        Returns
+        -------
+        int
+            The number of runs added, changed or removed.
+    */
+    int update(const std::string& directory = "data/handcarry22/rootified", bool verifyFiles = false, unsigned int nThreads = 16);
+
+    /*
+
+        Updates the location of a single run from its configuration file, e.g. after a filesystem event, without listing any directory.
+        Does nothing before the first update(), which sets the directory of the index.
+
+        Parameters
+        ----------
+        station : int
+            The station number.
+        run : int
+            The run number.
+        kind : ConfigChangeKind
+            Set to whether the run was added, removed or modified.
+
+        Returns
+        -------
+        bool
+            Whether the run was added, removed or its configuration file changed contents.
+    */
+    bool updateRun(int station, int run, ConfigChangeKind& kind);
+
+    /*
+        Reads an index saved by save(). Returns false, leaving the index empty, if the file cannot be read or is not an index.
+    */
+    bool load(const std::string& indexPath);
+
+    /*
+        Writes the index to a text file, replacing it atomically like writeConfigSnapshot. Returns false if it cannot be written.
+    */
+    bool save(const std::string& indexPath) const;
+
+private:
+    static constexpr const char* indexMagic = "# RNOGCFGI 1";
+
+    std::string directory_;
+    std::vector<ConfigLocation> locations_;
+    std::map<int, timespec> stations_;
+    // The station and run numbers of run directories without a configuration file
+    std::set<std::pair<int, int>> pending_;
+};
+
+/*
+
+    A run whose configuration file appeared, changed or disappeared, reported by ConfigWatcher.
+
+    Members
+    -------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    kind : ConfigChangeKind
+        Whether the configuration file was added, removed or modified.
+    location : ConfigLocation
+        The location of the file, see ConfigLocationIndex. Only the station, run and path are set for removed runs.
+    config : shared_ptr of const libconfig::Config
+        The parsed configuration, as held by the configuration cache. A null pointer for removed runs and files that cannot be parsed.
+*/
+
+struct ConfigUpdate
+{
+    int station = 0;
+    int run = 0;
+    ConfigChangeKind kind = ConfigChangeKind::Modified;
+    ConfigLocation location;
+    std::shared_ptr<const libconfig::Config> config;
+};
+
+/*
+
+    Watches the station<N>/run<M>/cfg/acq.cfg tree below a directory for new, modified and removed configuration files.
+
+    New and changed files are parsed into the configuration cache (see getConfigCache) and recorded in a ConfigLocationIndex, and
+    removed files are dropped from both, so the cost of an update only depends on the runs that changed. On Linux the watcher
+    subscribes to inotify events of the directory, the station directories and the cfg directory of every run (or the run directory
+    until its cfg directory exists). Elsewhere, if inotify is not available or runs out of watches, and on demand, it polls the index
+    instead, which only lists the station directories whose modification time changed and stats the run directories still waiting
+    for their configuration file (see ConfigLocationIndex::update).
+
+    Example:
+        ConfigWatcher watcher("data/handcarry22/rootified");
+        ConfigWatcher::Callback callback = [](const ConfigUpdate& update) { ... update.station, update.run, update.config ... };
+        watcher.start(callback);
+        watcher.run(callback);
+
+    Note:
+        inotify does not see changes made by other hosts on network filesystems, use polling on those. Polling reports a configuration
+        file as soon as it is written into a new or an existing run directory. It does not notice a file of an indexed run that is
+        replaced in place, which start() does find, since it updates the index with verifyFiles (see ConfigLocationIndex).
+*/
+
+class ConfigWatcher
+{
+public:
+    typedef std::function<void(const ConfigUpdate&)> Callback;
+
+    /*
+
+        Parameters
+        ----------
+        directory : string
+            The directory where the run data is stored.
+        index : ConfigLocationIndex
+            An index to continue from, e.g. loaded from disk, so that start() only reports what changed since it was saved.
+        forcePolling : bool
+            Poll even when filesystem events are available.
+        pollInterval : int
+            The milliseconds between two polls of the index.
+    */
+    ConfigWatcher(const std::string& directory, ConfigLocationIndex index = ConfigLocationIndex(), bool forcePolling = false, int pollInterval = 2000)
+        : directory_(resolveConfigPath(directory)), index_(std::move(index)), forcePolling_(forcePolling), pollInterval_(pollInterval) {}
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    ~ConfigWatcher();
+
+    /*
+        Updates the index and sets up the watches. Reports the runs added, modified or removed since the index passed to the
+        constructor to callback, parsing them into the cache like later updates. Without a callback the runs are only indexed.
+        Returns the number of runs added, modified or removed.
+    */
+    int start(const Callback& callback = Callback());
+
+    /*
+        Waits up to timeout milliseconds for changes and reports every changed run to callback, in station and run order.
+        Returns the number of runs reported.
+    */
+    int poll(int timeout, const Callback& callback);
+
+    // Reports changes to callback until stop() is called.
+    void run(const Callback& callback)
+    {
+        while (!stopped_)
+        {
+            // Wake up regularly to notice stop()
+            poll(200, callback);
+        }
+    }
+
+    // Makes run() return within a fraction of a second. Safe to call from another thread or a signal handler.
+    void stop()
+    {
+        stopped_ = true;
+    }
+
+    // Returns whether the watcher receives filesystem events, false if it polls.
+    bool usesEvents() const
+    {
+        return inotifyFd_ >= 0;
+    }
+
+    // Returns the index of the watched runs. Not synchronized with poll().
+    const ConfigLocationIndex& getIndex() const
+    {
+        return index_;
+    }
+
+private:
+    // What a watch descriptor watches: the directory itself (station < 0), a station directory (run < 0), a run or a cfg directory
+    struct Watch
+    {
+        int station;
+        int run;
+        bool cfg;
+    };
+
+    bool addWatch(const std::string& path, const Watch& watch);
+
+    // Watches a station directory and the runs in it, marking the runs as changed
+    bool watchStation(int station);
+
+    // Watches the cfg directory of a run, or the run directory until it has one, marking the run as changed
+    bool watchRun(int station, int run);
+
+    // Sets up the watches of the whole tree, returns false if the watcher must poll
+    bool openEvents();
+
+    // Reads the pending inotify events, returns false if events were lost or the watches cannot be kept up
+    bool readEvents();
+
+    // Updates the index and the cache for the changed runs and reports them
+    int applyChanges(const Callback& callback);
+
+    // Updates the index from the tree and reports the runs that differ from before
+    int pollIndex(const Callback& callback, bool verifyFiles);
+
+    ConfigUpdate makeUpdate(int station, int run, ConfigChangeKind kind);
+
+    void closeEvents();
+
+    const std::string directory_;
+    ConfigLocationIndex index_;
+    const bool forcePolling_;
+    const int pollInterval_;
+    std::atomic<bool> stopped_{false};
+    int inotifyFd_ = -1;
+    std::unordered_map<int, Watch> watches_;
+    std::set<std::pair<int, int>> changed_;
+    std::chrono::steady_clock::time_point nextPoll_;
+};
+
+/*
+
+    Packs the flattened configurations of a batch of runs into a single memory block.
+
+    A FlatConfig built by flattenConfig owns a few tables of its own. This function moves the tables of all runs into one block shared
+    by the batch: every path and string value is interned once for the whole batch (see internFlatConfigs), and the values stay inline
+    in their FlatSetting and FlatValue records, laid out like in a snapshot file. A season then takes a single allocation, and is
+    freed at once when the last FlatConfig of the batch is dropped.
+
+    Parameters
+    ----------
+    runs : vector of SnapshotRun
+        The runs whose configurations are replaced by views of the packed block.
+
+    Note:
+        A FlatConfig copied out of the batch keeps the whole block alive.
+*/
+
+void packFlatConfigs(std::vector<SnapshotRun>& runs);
+
+/*
+
+    Reads and flattens the configuration files of a set of runs.
+
+    Parameters
+    ----------
+    directory : string
+        The directory where the run data is stored.
+    runs : vector of ConfigRun
+        The runs to read, e.g. from findConfigRuns.
+    nThreads : unsigned int
+        The number of threads parsing configuration files.
+
+    Returns
+    -------
+    vector of SnapshotRun
+        The station, run and flattened configuration of every run that could be read, in the order of runs. The file times are left
+        unset. The configurations are packed into one memory block, see packFlatConfigs.
+*/
+
+std::vector<SnapshotRun> loadFlatConfigs(const std::string& directory, const std::vector<ConfigRun>& runs, unsigned int nThreads = 16);
+
+/*
+
+    A typed column of a configuration table, one per dotted path.
+
+    Members
+    -------
+    path : string
+        The dotted path of the setting.
+    name : string
+        The path with dots replaced by underscores, usable as a TTree branch name. Unique among the columns of a table, see
+        inferConfigBranches.
+    type : FlatType
+        The type of the values: Int, Int64, Float, Boolean or String for scalars, and Array for arrays and lists.
+    elementType : FlatType
+        The type of the elements of an Array column, None otherwise.
+*/
+
+struct ConfigBranchSpec
+{
+    std::string path;
+    std::string name;
+    FlatType type = FlatType::None;
+    FlatType elementType = FlatType::None;
+};
+
+/*
+    Combines the types a setting has in different runs: integers widen to Int64 and, mixed with floats, to Float. Other mixes keep the
+    first type, and the values that do not convert to it are exported as missing.
+*/
+
+FlatType mergeBranchTypes(FlatType a, FlatType b);
+
+/*
+
+    Infers the typed columns needed to store a set of flattened configurations as a table.
+
+    Parameters
+    ----------
+    runs : vector of SnapshotRun
+        The flattened configurations, e.g. from loadFlatConfigs or ConfigSnapshot::getRuns.
+    paths : vector of strings
+        The paths, group paths or common setting aliases to include. Empty includes every setting.
+
+    Returns
+    -------
+    vector of ConfigBranchSpec
+        One column per scalar, array or list setting found in any run, sorted by path.
+
+    Note:
+        Groups are represented by the columns of their settings. Lists holding groups, arrays or lists have no column.
+        Paths that give the same name, such as a.b_c and a_b.c, or a name of station or run, are told apart by a suffix _2, _3, ...
+        on the names of the later paths in sort order. The path of a column is always in its title in the TTree.
+*/
+
+std::vector<ConfigBranchSpec> inferConfigBranches(const std::vector<SnapshotRun>& runs, const std::vector<std::string>& paths = {});
+
+#ifdef RNOG_CONFIG_HAVE_ROOT
+
+/*
+    The values of one branch of the TTree written by exportConfigTree, for the run being filled.
+*/
+
+struct ConfigBranchBuffer
+{
+    Int_t intValue = 0;
+    Long64_t int64Value = 0;
+    Double_t floatValue = 0;
+    Bool_t boolValue = false;
+    std::string stringValue;
+    std::vector<Int_t> intValues;
+    std::vector<Long64_t> int64Values;
+    std::vector<Double_t> floatValues;
+    std::vector<bool> boolValues;
+    std::vector<std::string> stringValues;
+};
+
+// Sets the buffer of an Array branch from a value, leaving it empty if the value is missing.
+template <typename T>
+void fillBranchVector(std::vector<T>& values, const FlatConfig& flat, const FlatSetting* setting)
+{
+    values.clear();
+    if (!setting || (setting->value.type != FlatType::Array && setting->value.type != FlatType::List))
+    {
+        return;
+    }
+    const FlatValue* elements = flat.getElements(setting->value);
+    values.reserve(setting->value.elements.length);
+    for (uint32_t i = 0; i < setting->value.elements.length; ++i)
+    {
+        std::optional<T> element = convertFlatValue<T>(flat, elements[i]);
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            values.push_back(element.value_or(std::numeric_limits<T>::quiet_NaN()));
+        }
+        else
+        {
+            values.push_back(element.value_or(T()));
+        }
+    }
+}
+
+/*
+
+    Writes flattened configurations to a ROOT TTree, one entry per run and one typed branch per dotted path.
+
+    Besides the station and run branches, every setting gets a branch named after its path with dots replaced by underscores, and
+    titled with the dotted path. Integers are stored as I or L, floats as D, booleans as O, strings as std::string and arrays and lists
+    as std::vector of the element type. Runs that do not have a setting store NaN for floats, 0 or false for other scalars, and empty
+    strings and vectors.
+
+    Parameters
+    ----------
+    outputPath : string
+        The ROOT file to create. A relative path is resolved against the base directory.
+    runs : vector of SnapshotRun
+        The flattened configurations, e.g. from loadFlatConfigs or ConfigSnapshot::getRuns.
+    paths : vector of strings
+        The paths, group paths or common setting aliases to export. Empty exports every setting.
+    treeName : string
+        The name of the TTree.
+
+    Returns
+    -------
+    bool
+        True if the file was written.
+*/
+
+bool exportConfigTree(const std::string& outputPath, const std::vector<SnapshotRun>& runs, const std::vector<std::string>& paths = {}, const std::string& treeName = "configs");
+
+/*
+    Reads the configuration files of a set of runs and writes them to a ROOT TTree, see exportConfigTree.
+*/
+
+bool exportConfigTree(const std::string& outputPath, const std::string& directory, const std::vector<ConfigRun>& runs, const std::vector<std::string>& paths = {}, const std::string& treeName = "configs", unsigned int nThreads = 16);
+
+#endif
+
+/*
+
+    Comparison of a ConfigPredicate.
+*/
+
+enum class ConfigCompare
+{
+    Exists,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual
+};
+
+/*
+
+    A condition on one setting of a run, e.g. radiant.scalers.period < 1.
+
+    Members
+    -------
+    path : string
+        The path of a scalar setting, or station or run for the station and run numbers.
+    compare : ConfigCompare
+        The comparison. Exists matches the runs that have the setting, whatever its value.
+    isNumber : bool
+        True to compare numerically with number, false to compare strings with text. Booleans compare as the numbers 0 and 1.
+    number : double
+        The number to compare with.
+    text : string
+        The string to compare with.
+
+    Note:
+        Runs that do not have the setting match no predicate, including NotEqual.
+*/
+
+struct ConfigPredicate
+{
+    std::string path;
+    ConfigCompare compare = ConfigCompare::Exists;
+    bool isNumber = false;
+    double number = 0;
+    std::string text;
+};
+
+/*
+
+    Parses a query like "station == 23 && radiant.trigger.RF0.enabled == 1 && radiant.scalers.period < 1" into predicates.
+
+    Parameters
+    ----------
+    query : string
+        Conditions joined by &&. A condition is a path or common setting alias, optionally followed by one of ==, !=, <, <=, >, >= and
+        a value. true and false read as 1 and 0, numbers are compared numerically and anything else, optionally in double quotes, as a
+        string. A path alone requires the setting to exist.
+    predicates : vector of ConfigPredicate
+        Set to the parsed predicates.
+
+    Returns
+    -------
+    bool
+        True if the query was parsed. Errors are reported to the error log, see getConfigErrorLog.
+*/
+
+bool parseConfigQuery(const std::string& query, std::vector<ConfigPredicate>& predicates);
+
+/*
+
+    Selects runs of a season by conditions on their configuration.
+
+    The index keeps the flattened configurations of the runs and, for every path used in a query, a sorted index of the values that
+    path has across the runs. A condition is answered by a binary search in that index and gives a bitmap of the matching runs; the
+    bitmaps of the conditions are intersected. Indexes are built on the first query that uses their path, so a query over tens of
+    thousands of runs only touches the configurations once per new path.
+
+    Example:
+        ConfigQueryIndex index(loadFlatConfigs(directory, findConfigRuns(directory)));
+        std::vector<ConfigRun> runs = index.select("station == 23 && radiant.trigger.RF0.enabled == 1 && radiant.scalers.period < 1");
+
+    Note:
+        Only scalar settings can be queried. A path that no run has matches nothing and is not indexed, so queries from clients cannot
+        grow the index with paths that do not exist. The index is thread-safe.
+*/
+
+class ConfigQueryIndex
+{
+public:
+    // Builds the index over the runs, e.g. from loadFlatConfigs or ConfigSnapshot::getRuns.
+    explicit ConfigQueryIndex(std::vector<SnapshotRun> runs) : runs_(std::move(runs))
+    {
+        std::stable_sort(runs_.begin(), runs_.end(), [](const SnapshotRun& a, const SnapshotRun& b)
+        {
+            return std::make_pair(a.station, a.run) < std::make_pair(b.station, b.run);
+        });
+    }
+
+    // Returns the number of runs in the index.
+    size_t size() const
+    {
+        return runs_.size();
+    }
+
+    // Returns the runs matching all predicates, sorted by station and run.
+    std::vector<ConfigRun> select(const std::vector<ConfigPredicate>& predicates) const;
+
+    // Returns the runs matching a query, see parseConfigQuery. Returns no runs if the query cannot be parsed.
+    std::vector<ConfigRun> select(const std::string& query) const
+    {
+        std::vector<ConfigPredicate> predicates;
+        if (!parseConfigQuery(query, predicates))
+        {
+            return {};
+        }
+        return select(predicates);
+    }
+
+private:
+    // The values a path has across the runs, sorted by value, with the index of the run holding each value.
+    struct PathIndex
+    {
+        std::vector<std::pair<double, uint32_t>> numbers;
+        std::vector<std::pair<std::string_view, uint32_t>> strings;
+    };
+
+    const PathIndex& getPathIndex(const std::string& path) const;
+
+    // Sets the bits of the runs of entries [first, last) of a sorted value index.
+    template <typename Iterator>
+    static void setBits(std::vector<uint64_t>& bits, Iterator first, Iterator last)
+    {
+        for (; first != last; ++first)
+        {
+            bits[first->second / 64] |= uint64_t(1) << (first->second % 64);
+        }
+    }
+
+    // Sets the bits of the runs whose value in a sorted value index compares to key as requested.
+    template <typename Entries, typename Key>
+    static void matchValues(std::vector<uint64_t>& bits, const Entries& entries, ConfigCompare compare, const Key& key)
+    {
+        auto lower = std::lower_bound(entries.begin(), entries.end(), key, [](const auto& entry, const Key& k) { return entry.first < k; });
+        auto upper = std::upper_bound(lower, entries.end(), key, [](const Key& k, const auto& entry) { return k < entry.first; });
+        switch (compare)
+        {
+        case ConfigCompare::Exists: setBits(bits, entries.begin(), entries.end()); break;
+        case ConfigCompare::Equal: setBits(bits, lower, upper); break;
+        case ConfigCompare::NotEqual: setBits(bits, entries.begin(), lower); setBits(bits, upper, entries.end()); break;
+        case ConfigCompare::Less: setBits(bits, entries.begin(), lower); break;
+        case ConfigCompare::LessEqual: setBits(bits, entries.begin(), upper); break;
+        case ConfigCompare::Greater: setBits(bits, upper, entries.end()); break;
+        case ConfigCompare::GreaterEqual: setBits(bits, lower, entries.end()); break;
+        }
+    }
+
+    std::vector<uint64_t> match(const ConfigPredicate& predicate) const;
+
+    std::vector<SnapshotRun> runs_;
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<SettingPathId, PathIndex> indexes_;
+};
+
+/*
+
+    Type a ConfigSchemaRule expects of a setting. Int matches Int and Int64 settings, Number matches any integer or float and Any
+    matches every type.
+*/
+
+enum class ConfigSchemaType
+{
+    Any,
+    Int,
+    Float,
+    Number,
+    Boolean,
+    String,
+    Group,
+    Array,
+    List
+};
+
+/*
+
+    A rule of a ConfigSchema on one setting.
+
+    Members
+    -------
+    path : string
+        The dotted path of the setting.
+    type : ConfigSchemaType
+        The expected type of the setting.
+    elementType : ConfigSchemaType
+        The expected type of the elements of an array or list.
+    required : bool
+        Whether a configuration without the setting violates the rule.
+    minimum, maximum : double
+        The allowed range of a number, or of every element of an array or list. Booleans count as 0 and 1.
+    minLength, maxLength : uint32_t
+        The allowed number of elements of an array or list, or of characters of a string.
+*/
+
+struct ConfigSchemaRule
+{
+    std::string path;
+    ConfigSchemaType type = ConfigSchemaType::Any;
+    ConfigSchemaType elementType = ConfigSchemaType::Any;
+    bool required = true;
+    double minimum = -std::numeric_limits<double>::infinity();
+    double maximum = std::numeric_limits<double>::infinity();
+    uint32_t minLength = 0;
+    uint32_t maxLength = std::numeric_limits<uint32_t>::max();
+};
+
+/*
+    Kind of a violation of a ConfigSchemaRule.
+*/
+
+enum class ConfigViolationKind
+{
+    Missing,
+    WrongType,
+    OutOfRange,
+    WrongLength
+};
+
+/*
+
+    A setting of a run that violates a rule of a ConfigSchema.
+
+    Members
+    -------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    rule : uint32_t
+        The index of the rule in ConfigSchema::getRules.
+    kind : ConfigViolationKind
+        How the setting violates the rule.
+    element : int
+        The element of an array or list with the wrong type or out of range, -1 for the setting itself.
+    value : double
+        The number out of range or the wrong length.
+*/
+
+struct ConfigViolation
+{
+    int station = 0;
+    int run = 0;
+    uint32_t rule = 0;
+    ConfigViolationKind kind = ConfigViolationKind::Missing;
+    int element = -1;
+    double value = 0;
+};
+
+/*
+
+    A declarative schema of the settings of a configuration, compiled once and checked against flattened configurations.
+
+    The rules are sorted by path and their types compiled to masks of FlatType, so a configuration is checked in a single merge of
+    the rules with its sorted index, without any lookup, string conversion or exception.
+
+    A schema is written one rule per line as a path, a type (any, int, float, number, bool, string, group, array or list) and
+    optional key=value fields, with # starting a comment:
+
+        radiant.scalers.period       number  min=0.1 max=10
+        radiant.trigger.RF0.enabled  bool
+        flower.thresholds            array   element=int min=0 max=255 length=4
+        radiant.comment              string  optional maxlength=64
+
+    The fields are required or optional (the default is required), min and max for the range of numbers and elements, length for
+    an exact number of elements (or characters), minlength and maxlength for a range of lengths, and element for the type of the
+    elements.
+
+    Example:
+        ConfigSchema schema;
+        schema.load("acq.schema");
+        printConfigViolations(schema, validateConfigs(schema, "data/handcarry22/rootified"));
+*/
+
+class ConfigSchema
+{
+public:
+    ConfigSchema() = default;
+
+    // Compiles a schema from rules. A later rule for the same path replaces an earlier one.
+    explicit ConfigSchema(std::vector<ConfigSchemaRule> rules)
+    {
+        compile(std::move(rules));
+    }
+
+    /*
+        Compiles a schema from its text, see the class documentation. Returns false, reporting the first invalid line with source as
+        the key, if the text cannot be parsed.
+    */
+    bool parse(std::string_view text, const std::string& source = "schema");
+
+    // Reads and compiles a schema file. Returns false if it cannot be read or parsed.
+    bool load(const std::string& schemaPath)
+    {
+        std::string contents;
+        if (!readFileContents(schemaPath, contents))
+        {
+            getConfigErrorLog().report(ConfigStatus::IOError, schemaPath);
+            return false;
+        }
+        return parse(contents, schemaPath);
+    }
+
+    // Returns the rules sorted by path.
+    const std::vector<ConfigSchemaRule>& getRules() const
+    {
+        return rules_;
+    }
+
+    /*
+        Checks a flattened configuration and appends its violations to violations, labelled with station and run, in rule order.
+        Returns the number of violations found.
+    */
+    size_t validate(const FlatConfig& flat, std::vector<ConfigViolation>& violations, int station = 0, int run = 0) const;
+
+private:
+    // The types of a rule as masks of the accepted FlatType values
+    struct CompiledRule
+    {
+        uint32_t typeMask;
+        uint32_t elementMask;
+        bool checkRange;
+        bool checkLength;
+    };
+
+    static uint32_t typeMask(ConfigSchemaType type);
+
+    void compile(std::vector<ConfigSchemaRule> rules);
+
+    // Checks a number of a setting or element against the range of a rule, setting number to the value checked
+    static bool inRange(const CompiledRule& compiled, const ConfigSchemaRule& rule, const FlatValue& value, double& number)
+    {
+        if (!compiled.checkRange)
+        {
+            return true;
+        }
+        switch (value.type)
+        {
+        case FlatType::Int:
+        case FlatType::Int64: number = static_cast<double>(value.intValue); break;
+        case FlatType::Float: number = value.floatValue; break;
+        case FlatType::Boolean: number = value.boolValue ? 1 : 0; break;
+        default: return true;
+        }
+        return number >= rule.minimum && number <= rule.maximum;
+    }
+
+    std::vector<ConfigSchemaRule> rules_;
+    std::vector<CompiledRule> compiled_;
+};
+
+/*
+
+    Checks the configurations of a set of runs against a schema in parallel.
+
+    Parameters
+    ----------
+    schema : ConfigSchema
+        The schema to check.
+    runs : vector of SnapshotRun
+        The runs to check, e.g. from loadFlatConfigs or a ConfigSnapshot.
+    nThreads : unsigned int
+        The number of threads checking configurations.
+
+    Returns
+    -------
+    vector of ConfigViolation
+        The violations of every run, in the order of runs and then of the rules.
+*/
+
+std::vector<ConfigViolation> validateConfigs(const ConfigSchema& schema, const std::vector<SnapshotRun>& runs, unsigned int nThreads = 16);
+
+/*
+    Checks the configurations of every run below a directory against a schema, parsing and checking the files in parallel. Runs whose
+    configuration cannot be read are reported to the error log, not as violations.
+*/
+
+std::vector<ConfigViolation> validateConfigs(const ConfigSchema& schema, const std::string& directory, unsigned int nThreads = 16);
+
+/*
+    Prints one line per violation, followed by the number of runs violating each rule that was violated.
+*/
+
+void printConfigViolations(const ConfigSchema& schema, const std::vector<ConfigViolation>& violations, std::ostream& out = std::cout);
+
+/*
+
+    The compression of an archive, detected from its first bytes by detectArchiveCompression.
+*/
+
+enum class ConfigArchiveCompression
+{
+    None,
+    Gzip,
+    Zstd
+};
+
+// Returns the compression of an archive from its magic number, None for anything that is neither gzip nor zstd.
+ConfigArchiveCompression detectArchiveCompression(const char* data, size_t size);
+
+/*
+
+    Finds the station and run of an archive member named like station<N>/run<M>/cfg/acq.cfg.
+
+    Parameters
+    ----------
+    name : string
+        The member name. Leading directories, e.g. ./ or data/handcarry22/rootified/, are allowed.
+    station, run : int
+        Set to the station and run numbers.
+
+    Returns
+    -------
+    bool
+        False if the member is not the configuration file of a run.
+*/
+
+bool parseConfigMemberName(std::string_view name, int& station, int& run);
+
+/*
+
+    Reads the name, size and type of a tar member from its 512 byte ustar or GNU header.
+
+    Returns
+    -------
+    bool
+        False if the checksum of the header does not match.
+
+    Note:
+        The name is joined with the ustar prefix. GNU long names and pax paths come in a member of their own before the header they
+        apply to, which ConfigArchive handles.
+*/
+
+bool parseTarHeader(const char* header, std::string& name, uint64_t& size, char& type);
+
+/*
+
+    The configuration files of a season read from a tar archive, without extracting it.
+
+    Archived seasons are tarballs of the rootified tree, optionally compressed with gzip or zstd. Opening an archive reads it once from
+    start to end and builds an index of its station<N>/run<M>/cfg/acq.cfg members, so runs are then found without reading the archive
+    again. Uncompressed archives are mapped into memory and the members are views of the mapping. Compressed archives are decompressed
+    as a stream, skipping everything but the configuration files, which are kept in memory.
+
+    Example:
+        ConfigArchive archive;
+        archive.open("handcarry22.tar.zst");
+        libconfig::Config cfg;
+        archive.readConfig(23, 327, cfg);
+        std::string period = getCommonSettingValue(cfg, "scalers_period");
+
+    Note:
+        gzip needs zlib and zstd needs libzstd at build time, see RNOG_CONFIG_HAVE_ZLIB and RNOG_CONFIG_HAVE_ZSTD. When a run is
+        stored more than once, the last member wins, as when extracting the archive.
+*/
+
+class ConfigArchive
+{
+public:
+    ConfigArchive() = default;
+    ConfigArchive(const ConfigArchive&) = delete;
+    ConfigArchive& operator=(const ConfigArchive&) = delete;
+
+    /*
+        Reads the archive and indexes its configuration files.
+
+        Returns
+        -------
+        bool
+            False, reporting to the error log, if the archive cannot be read or is not a valid tar archive.
+    */
+    bool open(const std::string& archivePath);
+
+    bool contains(int station, int run) const
+    {
+        return find(station, run) != nullptr;
+    }
+
+    // Returns the contents of the configuration file of a run, empty if the archive does not hold it.
+    std::string_view getMember(int station, int run) const;
+
+    // Parses the configuration file of a run, returning false, reporting to the error log, if it is missing or cannot be parsed.
+    bool readConfig(int station, int run, libconfig::Config& cfg) const;
+
+    // Returns the runs of the archive, sorted by station and run.
+    std::vector<ConfigRun> getRuns() const;
+
+    const std::string& getPath() const
+    {
+        return path_;
+    }
+
+    ConfigArchiveCompression getCompression() const
+    {
+        return compression_;
+    }
+
+private:
+    struct Member
+    {
+        int station;
+        int run;
+        size_t offset;
+        size_t size;
+    };
+
+    // The decompressed tar stream, defined in RNOGConfigReader.cxx.
+    class Input;
+
+    bool index(Input& input);
+    const Member* find(int station, int run) const;
+
+    std::string path_;
+    ConfigArchiveCompression compression_ = ConfigArchiveCompression::None;
+    std::shared_ptr<const MappedFile> mapping_;
+    std::string contents_;
+    std::vector<Member> members_;
+};
+
+/*
+
+    Reads settings from every configuration file of an archive in parallel, like scanConfigFiles for a directory.
+
+    Returns
+    -------
+    vector of RunConfigValues
+        The settings of each run of the archive, sorted by station and run.
+*/
+
+std::vector<RunConfigValues> scanConfigArchive(const ConfigArchive& archive, const std::vector<std::string>& configSettingPaths, unsigned int nThreads = 16);
+
+/*
+    Appends text to a response of ConfigServer, escaping backslashes, tabs and newlines so every response stays on one line.
+*/
+
+void appendEscaped(std::string& out, std::string_view text);
+
+/*
+
+    A resident service answering configuration requests over a Unix socket.
+
+    The server keeps the parsed configurations in the process-wide configuration cache and a flattened copy of the most recently
+    requested runs, so a request costs a stat of the file and a few lookups, instead of starting ROOT and parsing the file. Requests are
+    lines of text, answered by one line each in the same order, so clients may pipeline any number of requests without waiting for the
+    answers:
+
+        get <station> <run> <path or alias> ...    OK<TAB>value<TAB>value...   missing settings give empty values
+        query <conditions>                         OK<TAB>station/run<TAB>...  see parseConfigQuery, over the runs of the directory
+        reload                                     OK                          reloads the runs used by query in the background
+        stats                                      OK<TAB>hits<TAB>misses<TAB>entries of the configuration cache
+
+    Errors are answered with ERR<TAB>message. Tabs, newlines and backslashes in values are escaped as \t, \n and \\.
+
+    Example:
+        printf 'get 23 327 rf0_enabled radiant.scalers.period\n' | socat - UNIX-CONNECT:/tmp/rnog-config.sock
+
+    Note:
+        The server handles all clients on one thread with poll(), so the cost of a request is the lookup itself. The runs used by query
+        are loaded on a background thread when the server starts and on reload. Queries are answered with an error until the first load
+        is done, and from the previous runs while a reload is in progress. A client with more than a megabyte of unsent answers is not
+        read from until it receives them.
+*/
+
+class ConfigServer
+{
+public:
+    // Keeps the flattened configurations of up to maxFlatConfigs runs, the least recently requested are dropped first.
+    ConfigServer(const std::string& directory, const std::string& socketPath, size_t maxFlatConfigs = 1024)
+        : directory_(resolveConfigPath(directory)), socketPath_(resolveConfigPath(socketPath)), maxFlatConfigs_(maxFlatConfigs)
+    {
+    }
+
+    ConfigServer(const ConfigServer&) = delete;
+    ConfigServer& operator=(const ConfigServer&) = delete;
+
+    ~ConfigServer();
+
+    // Creates the socket, replacing a stale socket file, and starts loading the runs used by query. Returns false if the socket cannot
+    // be created, if the path is taken by a file that is not a socket, or if another server is listening on it.
+    bool start();
+
+    // Serves clients until stop() is called.
+    void run();
+
+    // Makes run() return within a fraction of a second. Safe to call from another thread or a signal handler.
+    void stop()
+    {
+        stopped_ = true;
+    }
+
+    /*
+        Answers one request line, without the trailing newline. Appends the answer, terminated by a newline, to response.
+    */
+    void handleRequest(std::string_view request, std::string& response);
+
+private:
+    // The most a client may have buffered, in requests not yet answered and in answers not yet sent.
+    static constexpr size_t maxClientBytes = 1024 * 1024;
+
+    struct Client
+    {
+        int fd;
+        bool inputClosed;
+        std::string input;
+        std::string output;
+    };
+
+    // A flattened configuration of a run, valid as long as the configuration cache hands out the same parsed configuration.
+    struct FlatEntry
+    {
+        uint64_t key;
+        std::shared_ptr<const libconfig::Config> config;
+        FlatConfig flat;
+    };
+
+    const FlatConfig* getFlatConfig(int station, int run);
+
+    // Returns the runs used by query, or a null pointer if they are still being loaded.
+    std::shared_ptr<const ConfigQueryIndex> getQueryIndex()
+    {
+        std::lock_guard<std::mutex> lock(queryMutex_);
+        return queryIndex_;
+    }
+
+    // Loads the runs used by query on the background thread, again after the current load if one is in progress.
+    void reloadQueryIndex();
+
+    // Reads what a client sent, up to maxClientBytes of unanswered requests.
+    void serve(Client& client);
+
+    // Answers the complete request lines of a client until its unsent answers reach maxClientBytes.
+    void answer(Client& client);
+
+    void flush(Client& client);
+
+    const std::string directory_;
+    const std::string socketPath_;
+    const size_t maxFlatConfigs_;
+    int listenFd_ = -1;
+    std::atomic<bool> stopped_{false};
+    std::vector<Client> clients_;
+    std::list<FlatEntry> flatLru_;
+    std::unordered_map<uint64_t, std::list<FlatEntry>::iterator> flatConfigs_;
+    std::mutex queryMutex_;
+    std::shared_ptr<const ConfigQueryIndex> queryIndex_;
+    bool queryLoading_ = false;
+    bool queryReloadPending_ = false;
+    std::thread queryLoader_;
+};
+
+/*
+    
+    Example of reading the configuration file for a run.
+
+    Parameters
+    ----------
+    station : int
+        The station number.
+    run : int
+        The run number.
+    directory : string
+        The directory where the run data is stored.
+    configSettingPath : string
+        The path to the common setting in the configuration file.
+
+    Returns
+    -------
+    string
+        The string representation of the setting value.
+
+    Note:
+        The function returns an empty string if the setting type is not supported.
+        The function only supports the following types of settings: integers, booleans, strings, arrays, and lists.
+        The function uses the settingValueToString function to convert the setting value to a string representation.
+
+*/
+
+void configReader(int station=23, int run=327, std::string directory="data/handcarry22/rootified", std::string setting_path_alias="radiant.scalers.use_pps");
+
+/*
+
+    Splits the comma separated paths or common setting aliases given to the wrappers below and the rnog-config tool.
+
+    Parameters
+    ----------
+    setting_path_aliases : string
+        Comma separated paths or common setting aliases, e.g. "radiant.scalers.period,rf0_enabled".
+
+    Returns
+    -------
+    vector of strings
+        The paths and aliases in order, without empty ones.
+*/
+
+std::vector<std::string> splitSettingPaths(const std::string& setting_path_aliases);
+
+/*
+
+    Prints a setting table for every run of a season.
+
+    Example:
+        root -l -b -q 'configReader.C' -e 'configScanner("data/handcarry22/rootified", "radiant.scalers.period,rf0_enabled")'
+
+    Parameters
+    ----------
+    directory : string
+        The directory where the run data is stored.
+    setting_path_aliases : string
+        Comma separated paths or common setting aliases to print.
+    nThreads : int
+        The number of threads reading files.
+*/
+
+void configScanner(std::string directory="data/handcarry22/rootified", std::string setting_path_aliases="radiant.scalers.period", int nThreads=16);
+
+/*
+
+    Builds or updates the configuration snapshot of a season, see updateConfigSnapshot.
+
+    Example:
+        root -l -b -q 'configReader.C' -e 'configSnapshot("season.snapshot", "data/handcarry22/rootified")'
+*/
+
+void configSnapshot(std::string snapshotPath="data/handcarry22/rootified/configs.snapshot", std::string directory="data/handcarry22/rootified", int nThreads=16);
+
+/*
+
+    Prints the configuration changes between consecutive runs of a station.
+
+    Example:
+        root -l -b -q 'configReader.C' -e 'configChanges(23, 0, 2000, "data/handcarry22/rootified", "rf0_enabled,radiant.trigger")'
+
+    Parameters
+    ----------
+    station : int
+        The station number.
+    firstRun, lastRun : int
+        The range of runs to compare.
+    directory : string
+        The directory where the run data is stored.
+    setting_path_aliases : string
+        Comma separated paths, group paths or common setting aliases to report. Empty reports every change.
+*/
+
+void configChanges(int station=23, int firstRun=0, int lastRun=1000000, std::string directory="data/handcarry22/rootified", std::string setting_path_aliases="");
+
+/*
+
+    Example of selecting the runs of a season by their configuration.
+
+    Parameters
+    ----------
+    query : string
+        The conditions, e.g. "station == 23 && radiant.trigger.RF0.enabled == 1 && radiant.scalers.period < 1", see parseConfigQuery.
+    directory : string
+        The directory where the run data is stored.
+    snapshotPath : string
+        A configuration snapshot of the season to query instead of reading the configuration files, see configSnapshot.
+*/
+
+void configQuery(std::string query="station == 23", std::string directory="data/handcarry22/rootified", std::string snapshotPath="");
+
+/*
+
+    Example of building or updating the index of the configuration files of a season.
+
+    Parameters
+    ----------
+    indexPath : string
+        The index file to create or update.
+    directory : string
+        The directory where the run data is stored.
+    verifyFiles : bool
+        Also check the files of stations without new or removed runs, see ConfigLocationIndex::update.
+*/
+
+void configIndex(std::string indexPath="data/handcarry22/rootified/configs.index", std::string directory="data/handcarry22/rootified", bool verifyFiles=false);
+
+/*
+
+    Example of running the configuration service, see ConfigServer. Runs until the process is stopped.
+
+    Parameters
+    ----------
+    socketPath : string
+        The path of the Unix socket to listen on.
+    directory : string
+        The directory where the run data is stored.
+*/
+
+void configServer(std::string socketPath="/tmp/rnog-config.sock", std::string directory="data/handcarry22/rootified");
+
+/*
+
+    Example of watching a season for new and changed runs, see ConfigWatcher. Prints a line for every run added, modified or removed,
+    with the given settings, until the process is stopped.
+
+    Example:
+        root -l -b -q 'configReader.C' -e 'configWatch("data/handcarry22/rootified", "configs.index", "radiant.scalers.period")'
+
+    Parameters
+    ----------
+    directory : string
+        The directory where the run data is stored.
+    indexPath : string
+        An index of the run config locations, see configIndex, to continue from and to keep up to date. Empty watches without an index,
+        reporting every run found at start as added.
+    setting_path_aliases : string
+        Comma separated paths or common setting aliases to print.
+*/
+
+void configWatch(std::string directory="data/handcarry22/rootified", std::string indexPath="", std::string setting_path_aliases="");
+
+/*
+
+    Example of checking the configurations of a season against a schema, see ConfigSchema.
+
+    Example:
+        root -l -b -q 'configReader.C' -e 'configValidate("acq.schema", "data/handcarry22/rootified")'
+
+    Parameters
+    ----------
+    schemaPath : string
+        The schema file.
+    directory : string
+        The directory where the run data is stored.
+    nThreads : int
+        The number of threads reading files.
+
+    Returns
+    -------
+    int
+        The number of violations, or -1 if the schema cannot be read.
+*/
+
+int configValidate(std::string schemaPath="acq.schema", std::string directory="data/handcarry22/rootified", int nThreads=16);
+
+/*
+
+    Prints a setting table for every run of an archived season, reading the tar, tar.gz or tar.zst archive without extracting it.
+
+    Example:
+        root -l -b -q 'configReader.C' -e 'configArchive("handcarry22.tar.zst", "radiant.scalers.period,rf0_enabled")'
+
+    Parameters
+    ----------
+    archivePath : string
+        The archive of the directory where the run data is stored, see ConfigArchive.
+    setting_path_aliases : string
+        Comma separated paths or common setting aliases to print.
+    nThreads : int
+        The number of threads parsing configurations.
+*/
+
+void configArchive(std::string archivePath="data/handcarry22.tar.zst", std::string setting_path_aliases="radiant.scalers.period", int nThreads=16);
+
+#ifdef RNOG_CONFIG_HAVE_ROOT
+
+/*
+
+    Example of exporting the configurations of a season to a ROOT TTree.
+
+    Parameters
+    ----------
+    outputPath : string
+        The ROOT file to create.
+    directory : string
+        The directory where the run data is stored.
+    setting_path_aliases : string
+        Comma separated paths, group paths or common setting aliases to export. Empty exports every setting.
+*/
+
+void configTree(std::string outputPath="data/handcarry22/rootified/configs.root", std::string directory="data/handcarry22/rootified", std::string setting_path_aliases="");
+
+#endif
+
+#endif
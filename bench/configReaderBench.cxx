@@ -0,0 +1,233 @@
+/*
+    Benchmarks of the config reader hot paths on synthetic acq.cfg files.
+
+    The synthetic configurations vary the depth of nested groups, the length of the per-channel arrays and the number of run files.
+    Results are written in a machine-readable format with the Google Benchmark options, e.g.
+
+        g++ -std=c++17 -O2 bench/configReaderBench.cxx -o configReaderBench -lconfig++ -lz -lbenchmark -lpthread
+        ./configReaderBench --benchmark_format=json --benchmark_out=configReaderBench.json
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <filesystem>
+
+#include "../configReader.C"
+
+/*
+    Generates the text of a synthetic acq.cfg.
+
+    Parameters
+    ----------
+    depth : int
+        The number of nested groups. Every group holds one of each setting type and the next group.
+    arrayLength : int
+        The length of the channel-indexed arrays.
+    groups : int
+        The number of top-level groups.
+*/
+
+std::string generateSyntheticConfig(int depth, int arrayLength, int groups)
+{
+    std::string text;
+    for (int g = 0; g < groups; ++g)
+    {
+        for (int level = 0; level < depth; ++level)
+        {
+            text += std::string(2 * level, ' ') + "group" + std::to_string(level == 0 ? g : level) + " = {\n";
+            std::string indent(2 * level + 2, ' ');
+            text += indent + "int_value = " + std::to_string(1000 + level) + ";\n";
+            text += indent + "float_value = " + std::to_string(0.5 + level) + ";\n";
+            text += indent + "bool_value = " + (level % 2 ? "true" : "false") + ";\n";
+            text += indent + "string_value = \"level" + std::to_string(level) + "\";\n";
+            text += indent + "float_array = [";
+            for (int i = 0; i < arrayLength; ++i)
+            {
+                text += (i ? ", " : "") + std::to_string(0.9 + 0.01 * i);
+            }
+            text += "];\n" + indent + "int_list = (";
+            for (int i = 0; i < arrayLength; ++i)
+            {
+                text += (i ? ", " : "") + std::to_string(100 * i);
+            }
+            text += ");\n";
+        }
+        for (int level = depth - 1; level >= 0; --level)
+        {
+            text += std::string(2 * level, ' ') + "};\n";
+        }
+    }
+    return text;
+}
+
+// Returns the path of a setting in the deepest group of the first top-level group of a synthetic configuration.
+std::string syntheticSettingPath(int depth, const std::string& name)
+{
+    std::string path;
+    for (int level = 0; level < depth; ++level)
+    {
+        path += "group" + std::to_string(level == 0 ? 0 : level) + ".";
+    }
+    return path + name;
+}
+
+/*
+    A directory of synthetic run configurations, laid out as station1/run<N>/cfg/acq.cfg, removed when the benchmark ends.
+*/
+
+class SyntheticSeason
+{
+public:
+    SyntheticSeason(int files, int depth, int arrayLength, int groups)
+    {
+        char pattern[] = "/tmp/rnog-config-bench-XXXXXX";
+        directory_ = mkdtemp(pattern);
+        std::string text = generateSyntheticConfig(depth, arrayLength, groups);
+        for (int run = 0; run < files; ++run)
+        {
+            std::filesystem::create_directories(directory_ + "/station1/run" + std::to_string(run) + "/cfg");
+            std::ofstream(getConfigFilepath(1, run, directory_)) << text;
+        }
+    }
+
+    ~SyntheticSeason()
+    {
+        std::filesystem::remove_all(directory_);
+    }
+
+    const std::string& getDirectory() const
+    {
+        return directory_;
+    }
+
+private:
+    std::string directory_;
+};
+
+static void BM_ReadFile(benchmark::State& state)
+{
+    const int depth = state.range(0);
+    const int arrayLength = state.range(1);
+    SyntheticSeason season(1, depth, arrayLength, 4);
+    const std::string configFilepath = getConfigFilepath(1, 0, season.getDirectory());
+    for (auto _ : state)
+    {
+        libconfig::Config cfg;
+        cfg.readFile(configFilepath.c_str());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(configFilepath));
+}
+BENCHMARK(BM_ReadFile)->ArgsProduct({{1, 4, 8}, {4, 24, 96}});
+
+static void BM_GetSettingValue(benchmark::State& state)
+{
+    const int depth = state.range(0);
+    libconfig::Config cfg;
+    cfg.readString(generateSyntheticConfig(depth, 24, 4));
+    const std::string path = syntheticSettingPath(depth, "int_value");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getSettingValue(cfg, path));
+    }
+}
+BENCHMARK(BM_GetSettingValue)->Arg(1)->Arg(4)->Arg(8);
+
+static void BM_GetSettingValueById(benchmark::State& state)
+{
+    const int depth = state.range(0);
+    libconfig::Config cfg;
+    cfg.readString(generateSyntheticConfig(depth, 24, 4));
+    const SettingPathId id = getSettingPathPool().intern(syntheticSettingPath(depth, "int_value"));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getSettingValue(cfg, id));
+    }
+}
+BENCHMARK(BM_GetSettingValueById)->Arg(1)->Arg(4)->Arg(8);
+
+static void BM_FlatConfigLookup(benchmark::State& state)
+{
+    const int depth = state.range(0);
+    libconfig::Config cfg;
+    cfg.readString(generateSyntheticConfig(depth, 24, 4));
+    FlatConfig flat = flattenConfig(cfg);
+    const std::string path = syntheticSettingPath(depth, "int_value");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(flat.find(path));
+    }
+}
+BENCHMARK(BM_FlatConfigLookup)->Arg(1)->Arg(4)->Arg(8);
+
+static void BM_FlattenConfig(benchmark::State& state)
+{
+    const int depth = state.range(0);
+    libconfig::Config cfg;
+    cfg.readString(generateSyntheticConfig(depth, 24, 4));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(flattenConfig(cfg));
+    }
+}
+BENCHMARK(BM_FlattenConfig)->Arg(1)->Arg(4)->Arg(8);
+
+static void BM_SettingValueToString(benchmark::State& state, const char* name)
+{
+    const int arrayLength = state.range(0);
+    libconfig::Config cfg;
+    cfg.readString(generateSyntheticConfig(1, arrayLength, 1));
+    const libconfig::Setting& setting = cfg.lookup(syntheticSettingPath(1, name));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(settingValueToString(setting));
+    }
+}
+BENCHMARK_CAPTURE(BM_SettingValueToString, int, "int_value")->Arg(24);
+BENCHMARK_CAPTURE(BM_SettingValueToString, float, "float_value")->Arg(24);
+BENCHMARK_CAPTURE(BM_SettingValueToString, bool, "bool_value")->Arg(24);
+BENCHMARK_CAPTURE(BM_SettingValueToString, string, "string_value")->Arg(24);
+BENCHMARK_CAPTURE(BM_SettingValueToString, array, "float_array")->Arg(4)->Arg(24)->Arg(96);
+BENCHMARK_CAPTURE(BM_SettingValueToString, list, "int_list")->Arg(4)->Arg(24)->Arg(96);
+
+static void BM_GetSettingValueGroup(benchmark::State& state)
+{
+    libconfig::Config cfg;
+    cfg.readString(generateSyntheticConfig(1, state.range(0), 1));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getSettingValue(cfg, "group0"));
+    }
+}
+BENCHMARK(BM_GetSettingValueGroup)->Arg(4)->Arg(24)->Arg(96);
+
+/*
+    End-to-end batch readConfigFile over a season of files. The second argument selects a cold cache (cleared before every pass over
+    the files) or a warm one.
+*/
+
+static void BM_ReadConfigFile(benchmark::State& state)
+{
+    const int files = state.range(0);
+    const bool cold = state.range(1) != 0;
+    SyntheticSeason season(files, 4, 24, 4);
+    const std::vector<std::string> paths = {syntheticSettingPath(4, "int_value"), syntheticSettingPath(4, "float_array"), "group1.string_value"};
+    getConfigCache().clear();
+    for (auto _ : state)
+    {
+        if (cold)
+        {
+            getConfigCache().clear();
+        }
+        for (int run = 0; run < files; ++run)
+        {
+            benchmark::DoNotOptimize(readConfigFile(1, run, season.getDirectory(), paths));
+        }
+    }
+    getConfigCache().clear();
+    state.SetItemsProcessed(state.iterations() * files);
+}
+BENCHMARK(BM_ReadConfigFile)->ArgsProduct({{1, 16, 128}, {1, 0}});
+
+BENCHMARK_MAIN();
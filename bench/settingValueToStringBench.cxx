@@ -0,0 +1,150 @@
+/*
+    Microbenchmark of settingValueToString against the stringstream based implementation it replaced.
+
+    Build and run with Google Benchmark:
+        g++ -std=c++17 -O2 bench/settingValueToStringBench.cxx -o settingValueToStringBench -lconfig++ -lz -lbenchmark -lpthread
+        ./settingValueToStringBench
+*/
+
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+
+#include "../configReader.C"
+
+/*
+    The previous implementation of settingValueToString, kept as the baseline of the benchmark.
+*/
+
+std::string legacySettingValueToString(const libconfig::Setting& setting)
+{
+    if (setting.getType() == libconfig::Setting::TypeInt)
+    {
+        int intValue = setting;
+        return std::to_string(intValue);
+    }
+    else if (setting.getType() == libconfig::Setting::TypeString)
+    {
+        std::string stringValue = setting;
+        return stringValue;
+    }
+    else if (setting.getType() == libconfig::Setting::TypeBoolean)
+    {
+        bool boolValue = setting;
+        return std::to_string(boolValue);
+    }
+    else if (setting.getType() == libconfig::Setting::TypeFloat)
+    {
+        float floatValue = setting;
+        return std::to_string(floatValue);
+    }
+    else if (setting.getType() == libconfig::Setting::TypeArray || setting.getType() == libconfig::Setting::TypeList)
+    {
+        const bool isArray = setting.getType() == libconfig::Setting::TypeArray;
+        std::stringstream ss;
+        std::string value = "";
+        for (int i = 0; i < setting.getLength(); ++i)
+        {
+            const libconfig::Setting& subsetting = setting[i];
+            if (subsetting.getType() == libconfig::Setting::TypeInt)
+            {
+                int intValue = subsetting;
+                ss << intValue;
+            }
+            if (subsetting.getType() == libconfig::Setting::TypeFloat)
+            {
+                float floatValue = subsetting;
+                ss << floatValue;
+            }
+            if (i == 0)
+            {
+                value += (isArray ? "[" : "(") + ss.str();
+            }
+            else if (i == setting.getLength() - 1)
+            {
+                value += "," + ss.str() + (isArray ? "]" : ")");
+            }
+            else
+            {
+                value += "," + ss.str();
+            }
+            ss.str("");
+        }
+        return value;
+    }
+    return "";
+}
+
+static const char* benchConfig =
+    "int_value = 16777215;\n"
+    "float_value = 0.95;\n"
+    "bool_value = true;\n"
+    "string_value = \"radiant\";\n"
+    "float_array = [0.95, 0.9, 0.85, 0.8, 1.25, 0.5, 0.95, 0.9, 0.85, 0.8, 1.25, 0.5, 0.95, 0.9, 0.85, 0.8, 1.25, 0.5, 0.95, 0.9, 0.85, 0.8, 1.25, 0.5];\n"
+    "int_array = [100, 200, 300, 400, 500, 600, 700, 800, 900, 1000, 1100, 1200, 1300, 1400, 1500, 1600, 1700, 1800, 1900, 2000, 2100, 2200, 2300, 2400];\n"
+    "mixed_list = (1, 2.5, 3, 4.75, 5);\n";
+
+static const libconfig::Config& getBenchConfig()
+{
+    static libconfig::Config config;
+    static bool parsed = false;
+    if (!parsed)
+    {
+        config.readString(benchConfig);
+        parsed = true;
+        const libconfig::Setting& root = config.getRoot();
+        for (int i = 0; i < root.getLength(); ++i)
+        {
+            if (legacySettingValueToString(root[i]) != settingValueToString(root[i]))
+            {
+                std::cerr << "Output mismatch for " << root[i].getName() << ": " << legacySettingValueToString(root[i]) << " != " << settingValueToString(root[i]) << std::endl;
+                std::abort();
+            }
+        }
+    }
+    return config;
+}
+
+static void BM_LegacySettingValueToString(benchmark::State& state, const char* path)
+{
+    const libconfig::Setting& setting = getBenchConfig().lookup(path);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(legacySettingValueToString(setting));
+    }
+}
+
+static void BM_SettingValueToString(benchmark::State& state, const char* path)
+{
+    const libconfig::Setting& setting = getBenchConfig().lookup(path);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(settingValueToString(setting));
+    }
+}
+
+static void BM_AppendSettingValue(benchmark::State& state, const char* path)
+{
+    const libconfig::Setting& setting = getBenchConfig().lookup(path);
+    std::string buffer;
+    for (auto _ : state)
+    {
+        buffer.clear();
+        appendSettingValue(buffer, setting);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+
+#define RNOG_FORMAT_BENCHMARKS(path) \
+    BENCHMARK_CAPTURE(BM_LegacySettingValueToString, path, #path); \
+    BENCHMARK_CAPTURE(BM_SettingValueToString, path, #path); \
+    BENCHMARK_CAPTURE(BM_AppendSettingValue, path, #path)
+
+RNOG_FORMAT_BENCHMARKS(int_value);
+RNOG_FORMAT_BENCHMARKS(float_value);
+RNOG_FORMAT_BENCHMARKS(bool_value);
+RNOG_FORMAT_BENCHMARKS(string_value);
+RNOG_FORMAT_BENCHMARKS(float_array);
+RNOG_FORMAT_BENCHMARKS(int_array);
+RNOG_FORMAT_BENCHMARKS(mixed_list);
+
+BENCHMARK_MAIN();
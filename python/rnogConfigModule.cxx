@@ -0,0 +1,243 @@
+/*
+    Python bindings of libRNOGConfigReader, built as the rnog_config module with -DRNOG_CONFIG_PYTHON=ON (see CMakeLists.txt).
+
+        import rnog_config
+        values = rnog_config.readConfigFile(23, 327, "data/handcarry22/rootified", ["rf0_enabled", "radiant.scalers.period"])
+        runs, thresholds, found = rnog_config.extractConfigColumn("data/handcarry22/rootified", "radiant.thresholds.initial")
+
+    The functions keep the names and arguments of the C++ functions they wrap. Bulk results are numpy arrays viewing the buffers the
+    library filled, kept alive by the arrays, so nothing is copied on the way to Python. The GIL is released while files are read and
+    parsed, so other Python threads keep running during a scan.
+*/
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include "RNOGConfigReader.h"
+
+namespace py = pybind11;
+
+// Returns a numpy array viewing data, which stays valid as long as owner, the capsule of the object holding it, is alive.
+template <typename T>
+static py::array viewArray(const T* data, std::vector<py::ssize_t> shape, std::vector<py::ssize_t> strides, const py::capsule& owner)
+{
+    return py::array(py::dtype::of<T>(), std::move(shape), std::move(strides), data, owner);
+}
+
+// Returns the station and run numbers of runs as an n x 2 int32 array viewing the vector, which the array takes ownership of.
+static py::array runsArray(std::vector<ConfigRun> runs)
+{
+    std::vector<ConfigRun>* owned = new std::vector<ConfigRun>(std::move(runs));
+    py::capsule owner(owned, [](void* p) { delete static_cast<std::vector<ConfigRun>*>(p); });
+    // ConfigRun is a pair of ints, so the runs already form a row-major n x 2 block
+    static_assert(sizeof(ConfigRun) == 2 * sizeof(int), "ConfigRun must be two packed ints");
+    const py::ssize_t count = static_cast<py::ssize_t>(owned->size());
+    return viewArray<int>(owned->empty() ? nullptr : &owned->front().station, {count, 2}, {sizeof(ConfigRun), sizeof(int)}, owner);
+}
+
+// Converts an n x 2 array of station and run numbers, as returned by findConfigRuns, to runs.
+static std::vector<ConfigRun> toRuns(const py::array_t<int, py::array::c_style | py::array::forcecast>& array)
+{
+    if (array.ndim() != 2 || array.shape(1) != 2)
+    {
+        throw py::value_error("runs must be an n x 2 array of station and run numbers");
+    }
+    std::vector<ConfigRun> runs(static_cast<size_t>(array.shape(0)));
+    auto view = array.unchecked<2>();
+    for (py::ssize_t i = 0; i < array.shape(0); ++i)
+    {
+        runs[static_cast<size_t>(i)] = ConfigRun{view(i, 0), view(i, 1)};
+    }
+    return runs;
+}
+
+// Returns the runs, values and found arrays of a column, viewing the column, which the arrays take ownership of.
+template <typename T>
+static py::tuple columnArrays(ConfigColumn<T>&& column)
+{
+    ConfigColumn<T>* owned = new ConfigColumn<T>(std::move(column));
+    py::capsule owner(owned, [](void* p) { delete static_cast<ConfigColumn<T>*>(p); });
+    const py::ssize_t count = static_cast<py::ssize_t>(owned->runs.size());
+    const py::ssize_t width = static_cast<py::ssize_t>(owned->width);
+    py::array runs = viewArray<int>(owned->runs.empty() ? nullptr : &owned->runs.front().station, {count, 2}, {sizeof(ConfigRun), sizeof(int)}, owner);
+    py::array values = viewArray<T>(owned->values.data(), {count, width}, {static_cast<py::ssize_t>(owned->width * sizeof(T)), sizeof(T)}, owner);
+    // found holds 0 or 1 per byte, which numpy reads as bool
+    py::array found(py::dtype::of<bool>(), {count}, {static_cast<py::ssize_t>(sizeof(uint8_t))}, owned->found.data(), owner);
+    return py::make_tuple(runs, values, found);
+}
+
+// Extracts a column with the element type named by dtype, releasing the GIL while the files are read.
+template <typename Extract>
+static py::tuple extractColumn(const std::string& dtype, Extract extract)
+{
+    const std::string type = py::str(py::dtype(dtype));
+    if (type == "float32")
+    {
+        ConfigColumn<float> column;
+        {
+            py::gil_scoped_release release;
+            column = extract(float());
+        }
+        return columnArrays(std::move(column));
+    }
+    if (type == "float64")
+    {
+        ConfigColumn<double> column;
+        {
+            py::gil_scoped_release release;
+            column = extract(double());
+        }
+        return columnArrays(std::move(column));
+    }
+    if (type == "int32")
+    {
+        ConfigColumn<int32_t> column;
+        {
+            py::gil_scoped_release release;
+            column = extract(int32_t());
+        }
+        return columnArrays(std::move(column));
+    }
+    if (type == "int64")
+    {
+        ConfigColumn<int64_t> column;
+        {
+            py::gil_scoped_release release;
+            column = extract(int64_t());
+        }
+        return columnArrays(std::move(column));
+    }
+    throw py::type_error("dtype must be float32, float64, int32 or int64, not " + type);
+}
+
+// Returns the results of scanConfigFiles or scanConfigArchive as a dict of columns: station, run, parsed and one list per path.
+static py::dict scanResults(const std::vector<RunConfigValues>& results, const std::vector<std::string>& configSettingPaths)
+{
+    const py::ssize_t count = static_cast<py::ssize_t>(results.size());
+    py::array_t<int> stations(count);
+    py::array_t<int> runs(count);
+    py::array_t<bool> parsed(count);
+    auto stationView = stations.mutable_unchecked<1>();
+    auto runView = runs.mutable_unchecked<1>();
+    auto parsedView = parsed.mutable_unchecked<1>();
+    std::vector<py::list> columns(configSettingPaths.size());
+    for (py::ssize_t i = 0; i < count; ++i)
+    {
+        const RunConfigValues& result = results[static_cast<size_t>(i)];
+        stationView(i) = result.station;
+        runView(i) = result.run;
+        parsedView(i) = result.parsed;
+        for (size_t j = 0; j < columns.size(); ++j)
+        {
+            columns[j].append(j < result.values.size() ? result.values[j] : std::string());
+        }
+    }
+    py::dict table;
+    table["station"] = stations;
+    table["run"] = runs;
+    table["parsed"] = parsed;
+    for (size_t j = 0; j < columns.size(); ++j)
+    {
+        table[py::str(configSettingPaths[j])] = columns[j];
+    }
+    return table;
+}
+
+PYBIND11_MODULE(rnog_config, m)
+{
+    m.doc() = "Reads the station<N>/run<M>/cfg/acq.cfg configuration files of RNO-G runs, see RNOGConfigReader.h.";
+
+    m.def("setConfigBaseDirectory", &setConfigBaseDirectory, py::arg("baseDirectory"),
+          "Sets the directory that relative data directories are resolved against.");
+
+    m.def("setReadConcurrency", [](unsigned int limit) { getConfigReadLimiter().setLimit(limit); }, py::arg("limit"),
+          "Sets the number of configuration files read at the same time, 0 for unlimited, see ConfigReadLimiter.");
+
+    m.def("getErrorCount", []() { return getConfigErrorLog().getTotalCount(); },
+          "Returns the number of errors reported so far, e.g. missing settings or files that failed to parse.");
+
+    m.def("readConfigFile", [](int station, int run, const std::string& directory, const std::vector<std::string>& configSettingPaths)
+    {
+        std::unordered_map<std::string, std::string> values;
+        {
+            py::gil_scoped_release release;
+            values = readConfigFile(station, run, directory, configSettingPaths);
+        }
+        return values;
+    }, py::arg("station"), py::arg("run"), py::arg("directory"), py::arg("configSettingPaths"),
+       "Returns a dict of the settings of one run, by path or common setting alias. Missing settings map to an empty string and the "
+       "dict is empty if the file cannot be read.");
+
+    m.def("findConfigRuns", [](const std::string& directory)
+    {
+        std::vector<ConfigRun> runs;
+        {
+            py::gil_scoped_release release;
+            runs = findConfigRuns(directory);
+        }
+        return runsArray(std::move(runs));
+    }, py::arg("directory") = "data/handcarry22/rootified",
+       "Returns the station and run numbers of every configuration file below the directory as an n x 2 int32 array.");
+
+    m.def("scanConfigFiles", [](const std::string& directory, const std::vector<std::string>& configSettingPaths, unsigned int nThreads)
+    {
+        std::vector<RunConfigValues> results;
+        {
+            py::gil_scoped_release release;
+            results = scanConfigFiles(directory, configSettingPaths, nThreads);
+        }
+        return scanResults(results, configSettingPaths);
+    }, py::arg("directory"), py::arg("configSettingPaths"), py::arg("nThreads") = 16,
+       "Reads settings from every run of a season in parallel. Returns a dict with the station, run and parsed arrays and a list of "
+       "values per path, ready for pandas.DataFrame.");
+
+    m.def("scanConfigArchive", [](const std::string& archivePath, const std::vector<std::string>& configSettingPaths, unsigned int nThreads)
+    {
+        std::vector<RunConfigValues> results;
+        {
+            py::gil_scoped_release release;
+            ConfigArchive archive;
+            if (archive.open(archivePath))
+            {
+                results = scanConfigArchive(archive, configSettingPaths, nThreads);
+            }
+        }
+        return scanResults(results, configSettingPaths);
+    }, py::arg("archivePath"), py::arg("configSettingPaths"), py::arg("nThreads") = 16,
+       "Reads settings from every run of a tar, tar.gz or tar.zst archive, see scanConfigFiles.");
+
+    m.def("extractConfigColumn", [](const std::string& directory, const std::string& alias, size_t width, const std::string& dtype, py::object runs, unsigned int nThreads)
+    {
+        std::vector<ConfigRun> selected = runs.is_none() ? std::vector<ConfigRun>() : toRuns(runs.cast<py::array_t<int, py::array::c_style | py::array::forcecast>>());
+        const bool allRuns = runs.is_none();
+        return extractColumn(dtype, [&](auto type)
+        {
+            typedef decltype(type) T;
+            return extractConfigColumn<T>(directory, allRuns ? findConfigRuns(directory) : selected, alias, width, nThreads);
+        });
+    }, py::arg("directory"), py::arg("alias"), py::arg("width") = 24, py::arg("dtype") = "float32", py::arg("runs") = py::none(),
+       py::arg("nThreads") = 16,
+       "Extracts an array setting of many runs. Returns (runs, values, found): the n x 2 station and run numbers, the n x width values "
+       "and the n flags of the runs that had the setting, all viewing the library's buffers. runs defaults to every run of the directory.");
+
+    m.def("extractSnapshotColumn", [](const std::string& snapshotPath, const std::string& alias, size_t width, const std::string& dtype)
+    {
+        ConfigSnapshot snapshot;
+        bool opened;
+        {
+            py::gil_scoped_release release;
+            opened = snapshot.open(snapshotPath);
+        }
+        if (!opened)
+        {
+            throw py::value_error("cannot open the configuration snapshot " + snapshotPath);
+        }
+        return extractColumn(dtype, [&](auto type)
+        {
+            typedef decltype(type) T;
+            return extractConfigColumn<T>(snapshot, alias, width);
+        });
+    }, py::arg("snapshotPath"), py::arg("alias"), py::arg("width") = 24, py::arg("dtype") = "float32",
+       "Extracts an array setting of every run of a configuration snapshot, see extractConfigColumn.");
+}
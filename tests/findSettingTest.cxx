@@ -0,0 +1,75 @@
+/*
+    Checks that findSetting finds the same setting as libconfig's Config::exists and Config::lookup, for paths covering the syntax of
+    libconfig paths: nested groups, list and array indexes, indexes out of range, separators and the root.
+
+    Build and run with CTest (-DRNOG_CONFIG_TESTS=ON), or alone:
+        g++ -std=c++17 tests/findSettingTest.cxx -o findSettingTest -lconfig++ -lz -lpthread
+        ./findSettingTest
+
+    Exits with 77, which CTest reports as skipped, for libconfig versions before 1.7, whose path lookup findSetting does not follow.
+*/
+
+#include <iostream>
+
+#include "../configReader.C"
+
+static const char* fixture =
+    "radiant = { scalers = { period = 1.5; use_pps = true; }; thresholds = { initial = [0.5, 0.6, 0.7]; }; };\n"
+    "channels = ( { id = 0; gain = 2; }, { id = 1; gain = 3; } );\n"
+    "empty = {};\n"
+    "emptyList = ();\n"
+    "name = \"station\";\n"
+    "a = { b_c = 1; };\n"
+    "a_b = { c = 2; };\n";
+
+static const char* paths[] = {
+    // Nested groups
+    "radiant", "radiant.scalers", "radiant.scalers.period", "radiant.scalers.use_pps", "radiant.scalers.missing", "radiant.missing.period",
+    "a.b_c", "a_b.c", "a.b", "a_b_c", "name.sub",
+    // The other separators
+    "radiant:scalers:period", "radiant/scalers/period", "radiant.scalers/period", "empty", "empty.x",
+    // List and array indexes
+    "channels.[0]", "channels.[1].gain", "channels[1].gain", "channels.[0].id", "radiant.thresholds.initial.[2]",
+    "radiant.thresholds.initial[0]", "radiant.[0]", "radiant.[0].[1]", "name.[0]", "[0]", "[0].scalers", "channels.[]", "channels.[ 1]",
+    "channels.[+1].id", "channels.[-0].id",
+    // Indexes out of range, negative or malformed
+    "channels.[2]", "channels.[-1]", "emptyList.[0]", "radiant.thresholds.initial.[3]", "radiant.thresholds.initial.[99]",
+    "channels.[1", "channels.[x]", "channels.[1]x", "channels.[1]]",
+    // Leading, trailing and repeated separators
+    ".radiant", "radiant.", "radiant.scalers.period.", "radiant.scalers.period:", "name.", "channels.[0].", "radiant..scalers",
+    "radiant.scalers..period", "..radiant",
+    // The root and empty names
+    "", ".", ":", "/", "..",
+};
+
+int main()
+{
+#if defined(LIBCONFIGXX_VER_MAJOR) && (LIBCONFIGXX_VER_MAJOR > 1 || LIBCONFIGXX_VER_MINOR >= 7)
+    libconfig::Config config;
+    config.readString(fixture);
+    int failures = 0;
+    int existing = 0;
+    for (const char* path : paths)
+    {
+        const libconfig::Setting* expected = nullptr;
+        if (config.exists(path))
+        {
+            expected = &config.lookup(path);
+            ++existing;
+        }
+        const libconfig::Setting* found = findSetting(config.getRoot(), path);
+        if (found != expected)
+        {
+            std::cerr << "findSetting(\"" << path << "\") found " << (found ? "a setting" : "nothing") << ", libconfig "
+                      << (expected ? (found ? "another one" : "a setting") : "nothing") << "\n";
+            ++failures;
+        }
+    }
+    std::cout << sizeof(paths) / sizeof(paths[0]) << " paths, " << existing << " found by libconfig, " << failures << " failures\n";
+    // A fixture that did not parse would find nothing with either
+    return failures == 0 && existing > 0 ? 0 : 1;
+#else
+    std::cout << "libconfig before 1.7, skipped\n";
+    return 77;
+#endif
+}
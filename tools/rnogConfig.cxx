@@ -0,0 +1,164 @@
+/*
+    Command line front end of libRNOGConfigReader for batch jobs, running the configReader.C examples without ROOT.
+
+        rnog-config [-d directory] [-j threads] [-r readers] <command> [arguments]
+
+    Commands
+    --------
+    get <station> <run> <paths>                          Prints the settings of one run.
+    scan <paths>                                         Prints a table of the settings of every run.
+    snapshot <snapshotPath>                              Creates or updates a snapshot of every run.
+    changes <station> <firstRun> <lastRun> [paths]       Prints the settings that change between consecutive runs.
+    query <query> [snapshotPath]                         Prints the runs matching a query, see parseConfigQuery.
+    index <indexPath> [verify]                           Creates or updates an index of the run config locations.
+    serve <socketPath>                                   Runs the configuration service, see ConfigServer.
+    watch [indexPath] [paths]                            Prints the runs added, modified or removed, see ConfigWatcher.
+    validate <schemaPath>                                Checks every run against a schema, see ConfigSchema.
+    archive <archivePath> <paths>                        Prints a table of the settings of every run of a tar archive.
+    tree <outputPath> [paths]                            Exports the settings of every run to a ROOT TTree (ROOT builds only).
+
+    Paths are comma separated paths, group paths or common setting aliases. The threads parse the run configs, with at most readers of
+    them reading a file at the same time, see ConfigReadLimiter. Relative paths are relative to the current directory.
+*/
+
+#include <cstdlib>
+#include <cstring>
+
+#include "RNOGConfigReader.h"
+
+// Prints the usage of the command line front end.
+static void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [-d directory] [-j threads] [-r readers] <command> [arguments]\n"
+              << "Commands:\n"
+              << "    get <station> <run> <paths>\n"
+              << "    scan <paths>\n"
+              << "    snapshot <snapshotPath>\n"
+              << "    changes <station> <firstRun> <lastRun> [paths]\n"
+              << "    query <query> [snapshotPath]\n"
+              << "    index <indexPath> [verify]\n"
+              << "    serve <socketPath>\n"
+              << "    watch [indexPath] [paths]\n"
+              << "    validate <schemaPath>\n"
+              << "    archive <archivePath> <paths>\n"
+#ifdef RNOG_CONFIG_HAVE_ROOT
+              << "    tree <outputPath> [paths]\n"
+#endif
+              << "Paths are comma separated paths, group paths or common setting aliases." << std::endl;
+}
+
+// Parses an integer argument, returns false if the argument is not a whole integer.
+static bool parseInteger(const char* text, int& value)
+{
+    char* end = nullptr;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0')
+    {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    // The library resolves relative paths against its base directory, which for a command line tool is where it was started
+    if (char* cwd = getcwd(nullptr, 0))
+    {
+        setConfigBaseDirectory(cwd);
+        std::free(cwd);
+    }
+
+    std::string directory = "data/handcarry22/rootified";
+    int nThreads = 16;
+    int nReaders = 0;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; ++i)
+    {
+        if (std::strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+        {
+            directory = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc && parseInteger(argv[i + 1], nThreads) && nThreads > 0)
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc && parseInteger(argv[i + 1], nReaders) && nReaders >= 0)
+        {
+            ++i;
+            getConfigReadLimiter().setLimit(nReaders);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (i >= argc)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    const std::string command = argv[i];
+    const int nArgs = argc - i - 1;
+    char** args = argv + i + 1;
+    int station = 0;
+    int run = 0;
+    int lastRun = 0;
+    if (command == "get" && nArgs == 3 && parseInteger(args[0], station) && parseInteger(args[1], run))
+    {
+        for (const std::string& path : splitSettingPaths(args[2]))
+        {
+            readConfigFile(station, run, directory, path);
+        }
+    }
+    else if (command == "scan" && nArgs == 1)
+    {
+        configScanner(directory, args[0], nThreads);
+    }
+    else if (command == "snapshot" && nArgs == 1)
+    {
+        configSnapshot(args[0], directory, nThreads);
+    }
+    else if (command == "changes" && (nArgs == 3 || nArgs == 4) && parseInteger(args[0], station) && parseInteger(args[1], run) && parseInteger(args[2], lastRun))
+    {
+        configChanges(station, run, lastRun, directory, nArgs == 4 ? args[3] : "");
+    }
+    else if (command == "query" && (nArgs == 1 || nArgs == 2))
+    {
+        configQuery(args[0], directory, nArgs == 2 ? args[1] : "");
+    }
+    else if (command == "index" && (nArgs == 1 || (nArgs == 2 && std::strcmp(args[1], "verify") == 0)))
+    {
+        configIndex(args[0], directory, nArgs == 2);
+    }
+    else if (command == "serve" && nArgs == 1)
+    {
+        configServer(args[0], directory);
+    }
+    else if (command == "watch" && nArgs <= 2)
+    {
+        configWatch(directory, nArgs >= 1 ? args[0] : "", nArgs == 2 ? args[1] : "");
+    }
+    else if (command == "validate" && nArgs == 1)
+    {
+        return configValidate(args[0], directory, nThreads) == 0 ? 0 : 1;
+    }
+    else if (command == "archive" && nArgs == 2)
+    {
+        configArchive(args[0], args[1], nThreads);
+    }
+#ifdef RNOG_CONFIG_HAVE_ROOT
+    else if (command == "tree" && (nArgs == 1 || nArgs == 2))
+    {
+        configTree(args[0], directory, nArgs == 2 ? args[1] : "");
+    }
+#endif
+    else
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+    return getConfigErrorLog().getTotalCount() == 0 ? 0 : 1;
+}